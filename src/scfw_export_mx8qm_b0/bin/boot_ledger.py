@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+#
+# Copyright 2018 NXP
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""Print an SCFW boot ledger dump.
+
+Reads the binary buffer returned by the SCFW_BOOT_LEDGER board ioctl
+(board_boot_hdr_t followed by board_boot_rec_t entries, little endian)
+and prints each checkpoint with its time since reset and since the
+previous checkpoint. With --base, the time of each step is compared
+with a reference dump and the exit status is 1 if any step grew by more
+than --limit percent.
+
+Usage: boot_ledger.py [--base ref.bin [--limit PCT]] dump.bin
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x544F4F42
+HDR = struct.Struct("<IIII")
+REC = struct.Struct("<QII")
+
+NAMES = ["init", "ddr", "ddr done", "pmic", "pmic done", "config",
+         "partitions", "cpu"]
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HDR.size:
+        sys.exit("%s: short dump" % path)
+    magic, count, dropped, tick_hz = HDR.unpack_from(data, 0)
+    if magic != MAGIC:
+        sys.exit("%s: bad magic 0x%08x" % (path, magic))
+    if len(data) < HDR.size + count * REC.size:
+        sys.exit("%s: truncated, %d entries expected" % (path, count))
+    steps = []
+    prev = 0.0
+    for i in range(count):
+        ticks, cid, arg = REC.unpack_from(data, HDR.size + i * REC.size)
+        usec = ticks * 1000000.0 / tick_hz
+        name = NAMES[cid] if cid < len(NAMES) else "id%d" % cid
+        steps.append(("%s %u" % (name, arg), usec, usec - prev))
+        prev = usec
+    return steps, dropped
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--base", help="reference dump to compare with")
+    parser.add_argument("--limit", type=float, default=10.0,
+                        help="allowed growth per step in percent "
+                        "(default 10)")
+    parser.add_argument("dump")
+    opts = parser.parse_args()
+
+    steps, dropped = load(opts.dump)
+    base = {}
+    if opts.base:
+        base = {key: step for key, _, step in load(opts.base)[0]}
+
+    out = sys.stdout
+    worse = 0
+    for key, usec, step in steps:
+        line = "%12.1f us  %+10.1f us  %-16s" % (usec, step, key)
+        if key in base:
+            ref = base[key]
+            grow = (step - ref) * 100.0 / ref if ref > 0.0 else 0.0
+            line += "  ref %+10.1f us  %+6.1f%%" % (ref, grow)
+            if grow > opts.limit and step - ref >= 1.0:
+                line += "  REGRESSION"
+                worse += 1
+        out.write(line.rstrip() + "\n")
+    if dropped:
+        out.write("%d checkpoints dropped, ledger full\n" % dropped)
+
+    sys.exit(1 if worse else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+#
+# Copyright 2018 NXP
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""Expand a binary SCFW debug log (built with LB=1).
+
+Reads a debug UART capture and replaces the "#L" record lines written by
+board_log_drain() with the formatted text. Format strings and %s
+arguments are looked up by address in the SCFW ELF. Other lines are
+passed through unchanged.
+
+Usage: scfw_log.py [-t] [--tick-hz HZ] scfw_tcm.elf [capture.txt]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+ANCHOR = b"SCFW binary log anchor\0"
+HDR_WORDS = 3
+
+CONV = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?"
+                  r"(hh|h|ll|l|j|z|t)?([diouxXcsp%])")
+
+
+class Image:
+    """Loadable sections of an ELF, addressed by link address."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError("%s: not an ELF file" % path)
+        is64 = data[4] == 2
+        end = "<" if data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(end + "Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from(end + "HH", data, 0x3A)
+            shfmt = end + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(end + "I", data, 0x20)
+            shentsize, shnum = struct.unpack_from(end + "HH", data, 0x2E)
+            shfmt = end + "IIIIIIIIII"
+        self.sections = []
+        for i in range(shnum):
+            sh = struct.unpack_from(shfmt, data, shoff + i * shentsize)
+            sh_type, flags, addr, offset, size = sh[1], sh[2], sh[3], sh[4], sh[5]
+            # SHF_ALLOC, not SHT_NOBITS
+            if (flags & 0x2) and sh_type != 8 and size:
+                self.sections.append((addr, data[offset:offset + size]))
+        self.offset = 0
+
+    def relocate(self, anchor):
+        """Set the load offset from the runtime address of the anchor."""
+        for addr, body in self.sections:
+            pos = body.find(ANCHOR)
+            if pos >= 0:
+                self.offset = anchor - (addr + pos)
+                return
+        raise ValueError("log anchor not found, ELF does not match")
+
+    def string(self, runtime):
+        link = runtime - self.offset
+        for addr, body in self.sections:
+            if addr <= link < addr + len(body):
+                pos = link - addr
+                end = body.find(b"\0", pos)
+                if end < 0:
+                    end = len(body)
+                return body[pos:end].decode("latin-1")
+        return None
+
+
+def expand(image, fmt, args):
+    """Format a record the way the SCU printf would have."""
+    words = list(args)
+
+    def pull():
+        return words.pop(0) if words else None
+
+    def conv(m):
+        flags, width, prec, length, kind = m.groups()
+        if kind == "%":
+            return "%"
+        if width == "*":
+            w = pull()
+            width = str(w - (1 << 32) if w is not None and w & 0x80000000
+                        else w)
+        if prec == "*":
+            prec = str(pull())
+        val = pull()
+        if val is None:
+            return "<?>"
+        if length in ("ll", "j"):
+            hi = pull()
+            val |= (hi or 0) << 32
+            bits = 64
+        elif length == "h":
+            val &= 0xFFFF
+            bits = 16
+        elif length == "hh":
+            val &= 0xFF
+            bits = 8
+        else:
+            bits = 32
+        spec = "%" + flags + (width or "") + ("." + prec if prec else "")
+        if kind in "di":
+            if val & (1 << (bits - 1)):
+                val -= 1 << bits
+            return (spec + "d") % val
+        if kind == "u":
+            return (spec + "d") % val
+        if kind in "xXo":
+            return (spec + kind) % val
+        if kind == "c":
+            return (spec + "c") % chr(val & 0xFF)
+        if kind == "p":
+            return (spec + "s") % ("0x%x" % val)
+        text = image.string(val)
+        if text is None:
+            text = "<0x%08x>" % val
+        return (spec + "s") % text
+
+    return CONV.sub(conv, fmt)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-t", action="store_true",
+                        help="prefix records with a timestamp")
+    parser.add_argument("--tick-hz", type=int, default=8000000,
+                        help="SYSCTR frequency (default 8 MHz)")
+    parser.add_argument("elf")
+    parser.add_argument("capture", nargs="?")
+    opts = parser.parse_args()
+
+    image = Image(opts.elf)
+    src = open(opts.capture, "r", errors="replace") if opts.capture \
+        else sys.stdin
+    out = sys.stdout
+
+    for line in src:
+        rec = line.rstrip("\r\n")
+        if rec.startswith("#B") and len(rec) == 10:
+            image.relocate(int(rec[2:], 16))
+        elif rec.startswith("#D") and len(rec) == 10:
+            out.write("[binary log: %d records dropped]\n" % int(rec[2:], 16))
+        elif rec.startswith("#L") and (len(rec) - 2) % 8 == 0 \
+                and len(rec) >= 2 + HDR_WORDS * 8:
+            w = [int(rec[i:i + 8], 16) for i in range(2, len(rec), 8)]
+            fmt = image.string(w[0])
+            args = w[HDR_WORDS:HDR_WORDS + (w[2] & 0xFF)]
+            if opts.t:
+                out.write("[%12.6f] " % (w[1] / float(opts.tick_hz)))
+            if fmt is None:
+                out.write("<unknown format 0x%08x>\n" % w[0])
+            else:
+                out.write(expand(image, fmt, args))
+        else:
+            out.write(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -50,6 +50,15 @@
 #include "main/board.h"
 #include "main/monitor.h"
 #include "test/test.h"
+#include "drivers/common/fsl_common.h"
+#include "drivers/sysctr/fsl_sysctr.h"
+#include "all_svc.h"
+#include "svc/irq/rpc.h"
+#include "svc/pad/rpc.h"
+#include "svc/pm/rpc.h"
+#include "svc/rm/rpc.h"
+#include "svc/timer/rpc.h"
+#include "board/rpc_rec.h"
 
 /* Forced Error */
 
@@ -70,10 +79,88 @@
 
 /* Local Functions */
 
+static void board_timer_insert(board_timer_t *timer);
+static void board_timer_remove(const board_timer_t *timer);
+static sc_bool_t board_timer_linked(const board_timer_t *timer);
+static void board_timer_run(void);
+static void board_work_queue(board_work_q_t *q, board_work_t *work,
+    board_timer_cb_t cb);
+static void board_work_run(board_work_q_t *q);
+static void board_notify_window_end(void);
+static void ddr_periodic_tick(void);
+static void ddr_derate_periodic_tick(void);
+static sc_bool_t rpc_batch_failed(const sc_rpc_msg_t *msg, sc_rpc_svc_t svc);
+#if defined(DEBUG) && defined(BOARD_LOG_BINARY)
+    static void board_log_vwrite(const char *fmt, va_list args);
+    static uint32_t board_log_args(const char *fmt, va_list args,
+        uint32_t *words);
+#endif
+
+/* SS Functions (resolved by the linker --wrap option) */
+
+void __real_ss_irq_trigger(sc_irq_group_t group, uint32_t irq,
+    sc_rm_pt_t pt);
+void __wrap_ss_irq_trigger(sc_irq_group_t group, uint32_t irq,
+    sc_rm_pt_t pt);
+
+/* Driver Functions (resolved by the linker --wrap option) */
+
+void __real_SYSCTR_WakeEnable(uint32_t usec);
+void __wrap_SYSCTR_WakeEnable(uint32_t usec);
+
+/* Handlers (replace the weak defaults in the vector table) */
+
+void PendSV_Handler(void);
+
+/* Local Types */
+
+#if defined(SIMU) || defined(BOARD_DELAY_STATS)
+/*!
+ * Delay accounting for one call site
+ */
+typedef struct
+{
+    const char *file;
+    uint32_t line;
+    uint32_t calls;
+    uint64_t usec;
+} board_delay_site_t;
+#endif
+
 /* Local Variables */
 
-static sc_bool_t ddr_tick_enable = SC_FALSE;
-static sc_bool_t ddr_derate_tick_enable = SC_FALSE;
+#ifdef SIMU
+    static uint64_t board_vcounter = 0ULL;
+#endif
+#if defined(SIMU) || defined(BOARD_DELAY_STATS)
+    static board_delay_site_t board_delay_site[BOARD_DELAY_SITES];
+    static uint32_t board_delay_dropped = 0U;
+#endif
+#if defined(DEBUG) && defined(BOARD_LOG_BINARY)
+    static uint32_t board_log_ring[BOARD_LOG_RING_WORDS];
+    static uint32_t board_log_head = 0U;
+    static uint32_t board_log_tail = 0U;
+    static uint32_t board_log_dropped = 0U;
+    static uint32_t board_log_reported = 0U;
+    static sc_bool_t board_log_anchored = SC_FALSE;
+
+    /* Located in the ELF by the decoder to find the load offset */
+    static const char board_log_anchor[] = "SCFW binary log anchor";
+#endif
+static board_timer_t *board_timer_head = NULL;
+static board_work_q_t board_work_q = {NULL, NULL};
+static board_work_q_t board_rpc_work_q = {NULL, NULL};
+static board_timer_t ddr_timer;
+static board_timer_t ddr_derate_timer;
+static board_timer_t board_notify_timer;
+static uint32_t board_notify_window_ms = BOARD_NOTIFY_WINDOW_MS;
+static uint32_t board_notify_pend;
+static uint32_t board_notify_bits[SC_PT_ALL + 1U][SC_IRQ_NUM_GROUP];
+static uint8_t board_notify_imm[SC_PT_ALL + 1U];
+static board_notify_stats_t board_notify_stats;
+static board_boot_rec_t board_boot_ledger[BOARD_BOOT_LEDGER_MAX];
+static uint32_t board_boot_num = 0U;
+static uint32_t board_boot_dropped = 0U;
 
 /* Global Variables */
 
@@ -158,6 +245,18 @@ void board_monitor(void)
 /*--------------------------------------------------------------------------*/
 void board_exit(int32_t status)
 {
+    #ifdef SIMU
+        board_delay_report();
+        board_boot_report();
+    #endif
+
+    #if defined(DEBUG) && defined(BOARD_LOG_BINARY)
+        while (board_log_drain(BOARD_LOG_DRAIN_MAX) != 0U)
+        {
+            ; /* Flush */
+        }
+    #endif
+
     #ifdef DEBUG
         exit((int) status);
     #else
@@ -190,7 +289,10 @@ void board_printf(const char *fmt, ...)
 
         va_start(args, fmt);
 
-        #if defined(SIMU)
+        #if defined(BOARD_LOG_BINARY)
+            /* Formatting is deferred, so this works before the UART */
+            board_log_vwrite(fmt, args);
+        #elif defined(SIMU)
             (void) vfprintf(stderr, fmt, args);
         #else
             if (SCFW_DBG_READY != 0U)
@@ -207,6 +309,209 @@ void board_printf(const char *fmt, ...)
     #endif
 }
 
+#if defined(DEBUG) && defined(BOARD_LOG_BINARY)
+/*--------------------------------------------------------------------------*/
+/* Drain the binary debug log                                               */
+/*--------------------------------------------------------------------------*/
+uint32_t board_log_drain(uint32_t max)
+{
+    static const char hex[] = "0123456789abcdef";
+    char line[3U + ((BOARD_LOG_HDR_WORDS + BOARD_LOG_MAX_ARGS) * 8U) + 2U];
+    uint32_t count = 0U;
+    uint32_t dropped;
+
+    #ifndef SIMU
+        if (SCFW_DBG_READY == 0U)
+        {
+            return 0U;
+        }
+    #endif
+
+    /* Let the decoder relocate format addresses (SIMU is PIE) */
+    if (board_log_anchored == SC_FALSE)
+    {
+        (void) fprintf(stderr, "#B%08x\n",
+            U32((uintptr_t) board_log_anchor));
+        board_log_anchored = SC_TRUE;
+    }
+
+    dropped = __atomic_load_n(&board_log_dropped, __ATOMIC_RELAXED);
+    if (dropped != board_log_reported)
+    {
+        (void) fprintf(stderr, "#D%08x\n", dropped - board_log_reported);
+        board_log_reported = dropped;
+    }
+
+    while (count < max)
+    {
+        uint32_t tail = board_log_tail;
+        uint32_t len;
+        uint32_t pos = 2U;
+        uint32_t i;
+
+        /* The format word is written last and marks the record valid */
+        if (__atomic_load_n(&board_log_ring[tail
+            & (BOARD_LOG_RING_WORDS - 1U)], __ATOMIC_ACQUIRE) == 0U)
+        {
+            break;
+        }
+
+        len = BOARD_LOG_HDR_WORDS + (board_log_ring[(tail + 2U)
+            & (BOARD_LOG_RING_WORDS - 1U)] & 0xFFU);
+
+        line[0] = '#';
+        line[1] = 'L';
+        for (i = 0U; i < len; i++)
+        {
+            uint32_t *slot = &board_log_ring[(tail + i)
+                & (BOARD_LOG_RING_WORDS - 1U)];
+            uint32_t word = *slot;
+            uint32_t shift;
+
+            for (shift = 32U; shift > 0U; shift -= 4U)
+            {
+                line[pos] = hex[(word >> (shift - 4U)) & 0xFU];
+                pos++;
+            }
+            *slot = 0U;
+        }
+        line[pos] = '\n';
+        line[pos + 1U] = '\0';
+
+        /* Release the space to writers */
+        __atomic_store_n(&board_log_tail, tail + len, __ATOMIC_RELEASE);
+
+        (void) fputs(line, stderr);
+        count++;
+    }
+
+    return count;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Store a binary debug log record                                          */
+/*--------------------------------------------------------------------------*/
+static void board_log_vwrite(const char *fmt, va_list args)
+{
+    uint32_t rec[BOARD_LOG_HDR_WORDS + BOARD_LOG_MAX_ARGS];
+    uint32_t head;
+    uint32_t len;
+    uint32_t i;
+
+    rec[2] = board_log_args(fmt, args, &rec[BOARD_LOG_HDR_WORDS]);
+    rec[1] = U32(board_get_counter64());
+    len = BOARD_LOG_HDR_WORDS + rec[2];
+
+    /* Reserve space, safe against preemption by another writer */
+    head = __atomic_load_n(&board_log_head, __ATOMIC_RELAXED);
+    do
+    {
+        if ((head + len - __atomic_load_n(&board_log_tail,
+            __ATOMIC_ACQUIRE)) > BOARD_LOG_RING_WORDS)
+        {
+            (void) __atomic_fetch_add(&board_log_dropped, 1U,
+                __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&board_log_head, &head,
+        head + len, SC_TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    for (i = 1U; i < len; i++)
+    {
+        board_log_ring[(head + i) & (BOARD_LOG_RING_WORDS - 1U)] = rec[i];
+    }
+
+    /* Commit */
+    __atomic_store_n(&board_log_ring[head & (BOARD_LOG_RING_WORDS - 1U)],
+        U32((uintptr_t) fmt), __ATOMIC_RELEASE);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Copy the raw arguments of a format, return number of words               */
+/*--------------------------------------------------------------------------*/
+static uint32_t board_log_args(const char *fmt, va_list args,
+    uint32_t *words)
+{
+    uint32_t num = 0U;
+    const char *p = fmt;
+
+    while (*p != '\0')
+    {
+        uint32_t longs = 0U;
+        uint64_t val;
+
+        if (*p != '%')
+        {
+            p++;
+            continue;
+        }
+        p++;
+
+        /* Flags, width and precision */
+        while ((*p == '-') || (*p == '+') || (*p == ' ') || (*p == '#')
+            || (*p == '.') || (*p == '*') || ((*p >= '0') && (*p <= '9')))
+        {
+            if ((*p == '*') && (num < BOARD_LOG_MAX_ARGS))
+            {
+                words[num] = U32(va_arg(args, int));
+                num++;
+            }
+            p++;
+        }
+
+        /* Length */
+        while ((*p == 'l') || (*p == 'h') || (*p == 'j') || (*p == 'z')
+            || (*p == 't'))
+        {
+            if ((*p == 'l') || (*p == 'j'))
+            {
+                longs++;
+            }
+            p++;
+        }
+
+        if (*p == '\0')
+        {
+            break;
+        }
+
+        if (*p == '%')
+        {
+            p++;
+            continue;
+        }
+
+        /* long is 32-bit on the SCU, only ll/j take two words */
+        if (longs >= 2U)
+        {
+            val = va_arg(args, uint64_t);
+        }
+        else if ((*p == 's') || (*p == 'p'))
+        {
+            val = U64((uintptr_t) va_arg(args, const void *));
+        }
+        else
+        {
+            val = U64(va_arg(args, uint32_t));
+        }
+        p++;
+
+        if (num < BOARD_LOG_MAX_ARGS)
+        {
+            words[num] = U32(val);
+            num++;
+        }
+        if ((longs >= 2U) && (num < BOARD_LOG_MAX_ARGS))
+        {
+            words[num] = U32(val >> 32ULL);
+            num++;
+        }
+    }
+
+    return num;
+}
+#endif
+
 /*--------------------------------------------------------------------------*/
 /* DDR periodic enable                                                      */
 /*--------------------------------------------------------------------------*/
@@ -214,7 +519,19 @@ void board_ddr_periodic_enable(sc_bool_t enb)
 {
     if (board_ddr_period_ms != 0U)
     {
-        ddr_tick_enable = enb;
+        if (enb == SC_FALSE)
+        {
+            board_timer_stop(&ddr_timer);
+        }
+        else if (ddr_timer.active == SC_FALSE)
+        {
+            board_timer_start(&ddr_timer, ddr_periodic_tick,
+                board_ddr_period_ms, board_ddr_period_ms);
+        }
+        else
+        {
+            ; /* Intentional empty else */
+        }
     }
 }
 
@@ -224,7 +541,19 @@ void board_ddr_derate_periodic_enable(sc_bool_t enb)
 {
     if (board_ddr_derate_period_ms != 0U)
     {
-        ddr_derate_tick_enable = enb;
+        if (enb == SC_FALSE)
+        {
+            board_timer_stop(&ddr_derate_timer);
+        }
+        else if (ddr_derate_timer.active == SC_FALSE)
+        {
+            board_timer_start(&ddr_derate_timer, ddr_derate_periodic_tick,
+                board_ddr_derate_period_ms, board_ddr_derate_period_ms);
+        }
+        else
+        {
+            ; /* Intentional empty else */
+        }
     }
 }
 
@@ -233,29 +562,934 @@ void board_ddr_derate_periodic_enable(sc_bool_t enb)
 /*--------------------------------------------------------------------------*/
 void board_common_tick(uint16_t msec)
 {
-    if ((ddr_tick_enable != SC_FALSE) || (ddr_derate_tick_enable != SC_FALSE))
-    {
-        static uint32_t ddr_mseconds = 0U;
-        static uint32_t ddr_derate_mseconds = 0U;
+    #ifdef SIMU
+        /* Virtual time also passes between delays */
+        board_vcounter += SYSCTR_USEC_TO_TICKS64(U64(msec) * 1000ULL);
+    #endif
+
+    board_timer_run();
+
+    #ifdef SIMU
+        /* No PendSV, run posted work from the tick */
+        board_work_run(&board_work_q);
+    #endif
 
-        /* Tick DDR */
-        ddr_mseconds += msec;
-        ddr_derate_mseconds += msec;
+    #if defined(DEBUG) && defined(BOARD_LOG_BINARY)
+        (void) board_log_drain(BOARD_LOG_DRAIN_MAX);
+    #endif
+
+    board_tick(msec);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Arm a board timer                                                        */
+/*--------------------------------------------------------------------------*/
+void board_timer_start(board_timer_t *timer, board_timer_cb_t cb,
+    uint32_t delay_ms, uint32_t period_ms)
+{
+    ENTER_CS;
+    board_timer_remove(timer);
+
+    timer->cb = cb;
+    timer->period_ms = period_ms;
+    timer->deadline = board_get_counter64()
+        + SYSCTR_USEC_TO_TICKS64(U64(delay_ms) * 1000ULL);
+    timer->active = SC_TRUE;
+
+    board_timer_insert(timer);
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Disarm a board timer                                                     */
+/*--------------------------------------------------------------------------*/
+void board_timer_stop(board_timer_t *timer)
+{
+    ENTER_CS;
+    board_timer_remove(timer);
+    timer->active = SC_FALSE;
+    EXIT_CS;
+}
 
-        if ((ddr_tick_enable != SC_FALSE) && (board_ddr_period_ms != 0U) && (ddr_mseconds >= board_ddr_period_ms))
+/*--------------------------------------------------------------------------*/
+/* Time until the earliest board timer                                      */
+/*--------------------------------------------------------------------------*/
+uint32_t board_timer_next_usec(void)
+{
+    uint32_t usec = UINT32_MAX;
+
+    ENTER_CS;
+    if (board_timer_head != NULL)
+    {
+        uint64_t now = board_get_counter64();
+
+        if (board_timer_head->deadline <= now)
+        {
+            usec = 0U;
+        }
+        else
         {
-            ddr_mseconds = 0U;
+            uint64_t delta = SYSCTR_TICKS_TO_USEC64(
+                board_timer_head->deadline - now);
 
-            (void) board_ddr_config(SC_FALSE, BOARD_DDR_PERIODIC);
+            if (delta < U64(UINT32_MAX))
+            {
+                usec = U32(delta);
+            }
         }
-        if ((ddr_derate_tick_enable != SC_FALSE) && (board_ddr_derate_period_ms != 0U) && (ddr_derate_mseconds >= board_ddr_derate_period_ms))
+    }
+    EXIT_CS;
+
+    return usec;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Wake the SCU from low power in time for the earliest board timer         */
+/*--------------------------------------------------------------------------*/
+void __wrap_SYSCTR_WakeEnable(uint32_t usec)
+{
+    uint32_t wake = usec;
+
+    /* A zero request is passed through unchanged */
+    if (wake != 0U)
+    {
+        uint32_t next = board_timer_next_usec();
+
+        if (next < wake)
         {
-            ddr_derate_mseconds = 0U;
+            /* Due timers still need a wake in the future */
+            wake = (next != 0U) ? next : 1U;
+        }
+    }
+
+    __real_SYSCTR_WakeEnable(wake);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Queue work for the board worker                                          */
+/*--------------------------------------------------------------------------*/
+void board_work_post(board_work_t *work, board_timer_cb_t cb)
+{
+    board_work_queue(&board_work_q, work, cb);
+
+    #ifndef SIMU
+        NVIC_SetPriority(PendSV_IRQn, U32(BOARD_WORK_PRIO));
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    #endif
+}
+
+/*--------------------------------------------------------------------------*/
+/* Board worker                                                             */
+/*--------------------------------------------------------------------------*/
+void PendSV_Handler(void)
+{
+    board_work_run(&board_work_q);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Queue work for the next RPC                                              */
+/*--------------------------------------------------------------------------*/
+void board_rpc_work_post(board_work_t *work, board_timer_cb_t cb)
+{
+    board_work_queue(&board_rpc_work_q, work, cb);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Run work queued for RPC context                                          */
+/*--------------------------------------------------------------------------*/
+void board_rpc_work_run(void)
+{
+    board_work_run(&board_rpc_work_q);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Set up a deferred interrupt                                              */
+/*--------------------------------------------------------------------------*/
+void board_irq_defer_init(board_irq_defer_t *defer, IRQn_Type irq,
+    board_timer_cb_t work)
+{
+    static const board_irq_stats_t zero = {0U};
+
+    defer->irq = irq;
+    defer->work = work;
+    defer->item.queued = SC_FALSE;
+    defer->raised = 0ULL;
+    defer->stats = zero;
+
+    NVIC_ClearPendingIRQ(irq);
+    NVIC_EnableIRQ(irq);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Deferred interrupt top half                                              */
+/*--------------------------------------------------------------------------*/
+void board_irq_defer_raise(board_irq_defer_t *defer)
+{
+    uint64_t start = board_get_counter64();
+
+    /* Mask the (level) line until the bottom half has serviced it */
+    NVIC_DisableIRQ(defer->irq);
+    NVIC_ClearPendingIRQ(defer->irq);
+
+    defer->stats.irqs++;
+    if (defer->item.queued == SC_FALSE)
+    {
+        defer->raised = start;
+        board_work_post(&defer->item, defer->work);
+    }
+
+    defer->stats.isr_ticks = U32(board_get_counter64() - start);
+    if (defer->stats.isr_ticks > defer->stats.isr_max_ticks)
+    {
+        defer->stats.isr_max_ticks = defer->stats.isr_ticks;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Deferred interrupt bottom half done                                      */
+/*--------------------------------------------------------------------------*/
+void board_irq_defer_done(board_irq_defer_t *defer)
+{
+    uint64_t lat = SYSCTR_TICKS_TO_USEC64(board_get_counter64()
+        - defer->raised);
+
+    defer->stats.runs++;
+    defer->stats.lat_usec = U32(MIN(lat, U64(UINT32_MAX)));
+    if (defer->stats.lat_usec > defer->stats.lat_max_usec)
+    {
+        defer->stats.lat_max_usec = defer->stats.lat_usec;
+    }
 
-            (void) board_ddr_config(SC_FALSE, BOARD_DDR_DERATE_PERIODIC);
+    /* Still asserted lines fire again once unmasked */
+    NVIC_ClearPendingIRQ(defer->irq);
+    NVIC_EnableIRQ(defer->irq);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Post a partition notification                                            */
+/*--------------------------------------------------------------------------*/
+void board_notify(sc_irq_group_t group, uint32_t irq, sc_rm_pt_t pt)
+{
+    sc_bool_t deliver = SC_FALSE;
+
+    if ((group < SC_IRQ_NUM_GROUP) && (pt <= SC_PT_ALL))
+    {
+        ENTER_CS;
+        board_notify_stats.events++;
+        if ((board_notify_window_ms == 0U)
+            || (((BOARD_NOTIFY_IMMEDIATE | U32(board_notify_imm[pt]))
+            & BIT(group)) != 0U))
+        {
+            board_notify_stats.immediate++;
+            deliver = SC_TRUE;
         }
+        else if (board_notify_timer.active == SC_FALSE)
+        {
+            /* First in the window goes out now */
+            board_notify_stats.windows++;
+            board_timer_start(&board_notify_timer, board_notify_window_end,
+                board_notify_window_ms, 0U);
+            deliver = SC_TRUE;
+        }
+        else
+        {
+            board_notify_bits[pt][group] |= irq;
+            board_notify_pend |= BIT(pt);
+        }
+        if (deliver != SC_FALSE)
+        {
+            board_notify_stats.doorbells++;
+        }
+        EXIT_CS;
     }
 
-    board_tick(msec);
+    if (deliver != SC_FALSE)
+    {
+        __real_ss_irq_trigger(group, irq, pt);
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Route service notifications through the coalescing window                */
+/*--------------------------------------------------------------------------*/
+void __wrap_ss_irq_trigger(sc_irq_group_t group, uint32_t irq,
+    sc_rm_pt_t pt)
+{
+    if ((group < SC_IRQ_NUM_GROUP)
+        && ((BOARD_NOTIFY_GROUPS & BIT(group)) != 0U))
+    {
+        board_notify(group, irq, pt);
+    }
+    else
+    {
+        __real_ss_irq_trigger(group, irq, pt);
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Set the notification coalescing window                                   */
+/*--------------------------------------------------------------------------*/
+void board_notify_config(uint32_t window_ms)
+{
+    static const board_notify_stats_t zero = {0U};
+
+    board_timer_stop(&board_notify_timer);
+    (void) board_notify_flush();
+
+    ENTER_CS;
+    board_notify_window_ms = window_ms;
+    board_notify_stats = zero;
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Select immediate notification groups for a partition                     */
+/*--------------------------------------------------------------------------*/
+void board_notify_immediate(sc_rm_pt_t pt, uint32_t groups)
+{
+    uint8_t any = 0U;
+    sc_rm_pt_t p;
+
+    if (pt < SC_PT_ALL)
+    {
+        ENTER_CS;
+        board_notify_imm[pt] = U8(groups & (BIT(SC_IRQ_NUM_GROUP) - 1U));
+
+        /* Broadcasts follow the most demanding partition */
+        for (p = 0U; p < SC_PT_ALL; p++)
+        {
+            any |= board_notify_imm[p];
+        }
+        board_notify_imm[SC_PT_ALL] = any;
+        EXIT_CS;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Deliver pending notifications                                            */
+/*--------------------------------------------------------------------------*/
+uint32_t board_notify_flush(void)
+{
+    uint32_t doorbells = 0U;
+    sc_rm_pt_t pt;
+    sc_irq_group_t group;
+
+    for (pt = 0U; pt <= SC_PT_ALL; pt++)
+    {
+        if ((board_notify_pend & BIT(pt)) == 0U)
+        {
+            continue;
+        }
+
+        for (group = 0U; group < SC_IRQ_NUM_GROUP; group++)
+        {
+            uint32_t irq;
+
+            ENTER_CS;
+            irq = board_notify_bits[pt][group];
+            board_notify_bits[pt][group] = 0U;
+            if (irq != 0U)
+            {
+                board_notify_stats.doorbells++;
+            }
+            EXIT_CS;
+
+            if (irq != 0U)
+            {
+                __real_ss_irq_trigger(group, irq, pt);
+                doorbells++;
+            }
+        }
+
+        /* Bits posted during the flush are picked up next window */
+        ENTER_CS;
+        board_notify_pend &= ~BIT(pt);
+        for (group = 0U; group < SC_IRQ_NUM_GROUP; group++)
+        {
+            if (board_notify_bits[pt][group] != 0U)
+            {
+                board_notify_pend |= BIT(pt);
+            }
+        }
+        EXIT_CS;
+    }
+
+    return doorbells;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Return notification statistics                                           */
+/*--------------------------------------------------------------------------*/
+void board_notify_get_stats(board_notify_stats_t *stats)
+{
+    ENTER_CS;
+    *stats = board_notify_stats;
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Insert a timer in deadline order, call with interrupts masked            */
+/*--------------------------------------------------------------------------*/
+static void board_timer_insert(board_timer_t *timer)
+{
+    board_timer_t **link = &board_timer_head;
+
+    /* Equal deadlines run in arming order */
+    while ((*link != NULL) && ((*link)->deadline <= timer->deadline))
+    {
+        link = &((*link)->next);
+    }
+
+    timer->next = *link;
+    *link = timer;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Unlink a timer if armed, call with interrupts masked                     */
+/*--------------------------------------------------------------------------*/
+static void board_timer_remove(const board_timer_t *timer)
+{
+    board_timer_t **link = &board_timer_head;
+
+    while (*link != NULL)
+    {
+        if (*link == timer)
+        {
+            *link = timer->next;
+            break;
+        }
+        link = &((*link)->next);
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Check if a timer is in the list, call with interrupts masked             */
+/*--------------------------------------------------------------------------*/
+static sc_bool_t board_timer_linked(const board_timer_t *timer)
+{
+    const board_timer_t *t = board_timer_head;
+    sc_bool_t linked = SC_FALSE;
+
+    while (t != NULL)
+    {
+        if (t == timer)
+        {
+            linked = SC_TRUE;
+            break;
+        }
+        t = t->next;
+    }
+
+    return linked;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Append a work item to a queue                                            */
+/*--------------------------------------------------------------------------*/
+static void board_work_queue(board_work_q_t *q, board_work_t *work,
+    board_timer_cb_t cb)
+{
+    ENTER_CS;
+    if (work->queued == SC_FALSE)
+    {
+        work->cb = cb;
+        work->next = NULL;
+        work->queued = SC_TRUE;
+        if (q->tail == NULL)
+        {
+            q->head = work;
+        }
+        else
+        {
+            q->tail->next = work;
+        }
+        q->tail = work;
+    }
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Run the work of a queue in posting order                                 */
+/*--------------------------------------------------------------------------*/
+static void board_work_run(board_work_q_t *q)
+{
+    board_work_t *work;
+
+    do
+    {
+        ENTER_CS;
+        work = q->head;
+        if (work != NULL)
+        {
+            q->head = work->next;
+            if (q->head == NULL)
+            {
+                q->tail = NULL;
+            }
+            work->next = NULL;
+
+            /* The work function may post the item again */
+            work->queued = SC_FALSE;
+        }
+        EXIT_CS;
+
+        if (work != NULL)
+        {
+            work->cb();
+        }
+    }
+    while (work != NULL);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Run due board timers                                                     */
+/*--------------------------------------------------------------------------*/
+static void board_timer_run(void)
+{
+    board_timer_t *timer;
+
+    do
+    {
+        uint64_t now = board_get_counter64();
+
+        /* Pop the earliest timer if due */
+        ENTER_CS;
+        timer = board_timer_head;
+        if ((timer != NULL) && (timer->deadline <= now))
+        {
+            board_timer_head = timer->next;
+            timer->next = NULL;
+            if (timer->period_ms == 0U)
+            {
+                timer->active = SC_FALSE;
+            }
+        }
+        else
+        {
+            timer = NULL;
+        }
+        EXIT_CS;
+
+        if (timer != NULL)
+        {
+            board_timer_cb_t cb = timer->cb;
+
+            cb();
+
+            /* Reload unless stopped or restarted from the callback */
+            ENTER_CS;
+            if ((timer->active != SC_FALSE) && (timer->period_ms != 0U)
+                && (board_timer_linked(timer) == SC_FALSE))
+            {
+                uint64_t period = SYSCTR_USEC_TO_TICKS64(
+                    U64(timer->period_ms) * 1000ULL);
+
+                /* Don't try to catch up on missed periods */
+                timer->deadline += period;
+                if (timer->deadline <= now)
+                {
+                    timer->deadline = now + period;
+                }
+                board_timer_insert(timer);
+            }
+            EXIT_CS;
+        }
+    } while (timer != NULL);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Notification window closed                                               */
+/*--------------------------------------------------------------------------*/
+static void board_notify_window_end(void)
+{
+    /* Keep the window open while notifications keep arriving */
+    if (board_notify_flush() != 0U)
+    {
+        ENTER_CS;
+        if ((board_notify_window_ms != 0U)
+            && (board_notify_timer.active == SC_FALSE))
+        {
+            board_timer_start(&board_notify_timer, board_notify_window_end,
+                board_notify_window_ms, 0U);
+        }
+        EXIT_CS;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* DDR periodic timer callback                                              */
+/*--------------------------------------------------------------------------*/
+static void ddr_periodic_tick(void)
+{
+    (void) board_ddr_config(SC_FALSE, BOARD_DDR_PERIODIC);
+}
+
+/*--------------------------------------------------------------------------*/
+/* DDR derate periodic timer callback                                       */
+/*--------------------------------------------------------------------------*/
+static void ddr_derate_periodic_tick(void)
+{
+    (void) board_ddr_config(SC_FALSE, BOARD_DDR_DERATE_PERIODIC);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Board time base                                                          */
+/*--------------------------------------------------------------------------*/
+uint64_t board_get_counter64(void)
+{
+    #ifdef SIMU
+        return board_vcounter;
+    #else
+        return SYSCTR_GetCounter64();
+    #endif
+}
+
+#if defined(SIMU) || defined(BOARD_DELAY_STATS)
+/*--------------------------------------------------------------------------*/
+/* Delay with per call site accounting                                      */
+/*--------------------------------------------------------------------------*/
+void board_delay(uint32_t usec, const char *file, uint32_t line)
+{
+    #ifdef SIMU
+        board_vcounter += SYSCTR_USEC_TO_TICKS64(usec);
+    #else
+        SystemTimeDelay(usec);
+    #endif
+
+    board_delay_record(usec, file, line);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Record time against a call site                                          */
+/*--------------------------------------------------------------------------*/
+void board_delay_record(uint32_t usec, const char *file, uint32_t line)
+{
+    uint32_t i;
+
+    for (i = 0U; i < BOARD_DELAY_SITES; i++)
+    {
+        board_delay_site_t *site = &board_delay_site[i];
+
+        /* Claim the first free slot */
+        if (site->file == NULL)
+        {
+            site->file = file;
+            site->line = line;
+        }
+
+        if ((site->file == file) && (site->line == line))
+        {
+            site->calls++;
+            site->usec += U64(usec);
+            break;
+        }
+    }
+
+    if (i == BOARD_DELAY_SITES)
+    {
+        board_delay_dropped++;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Print delay report                                                       */
+/*--------------------------------------------------------------------------*/
+void board_delay_report(void)
+{
+    uint64_t total = 0ULL;
+    uint32_t i;
+
+    always_print("Delay report:\n");
+    for (i = 0U; i < BOARD_DELAY_SITES; i++)
+    {
+        const board_delay_site_t *site = &board_delay_site[i];
+
+        if (site->file != NULL)
+        {
+            always_print("  %s:%u calls=%u usec=%u\n", site->file,
+                site->line, site->calls, U32(site->usec));
+            total += site->usec;
+        }
+    }
+    always_print("  total usec=%u, dropped=%u\n", U32(total),
+        board_delay_dropped);
+    #ifdef SIMU
+        always_print("  simulated time usec=%u\n",
+            U32(SYSCTR_TICKS_TO_USEC64(board_vcounter)));
+    #endif
+}
+#endif
+
+/*--------------------------------------------------------------------------*/
+/* Record a boot checkpoint                                                 */
+/*--------------------------------------------------------------------------*/
+void board_boot_mark(uint32_t id, uint32_t arg)
+{
+    uint64_t ticks = board_get_counter64();
+
+    ENTER_CS;
+    if (board_boot_num < BOARD_BOOT_LEDGER_MAX)
+    {
+        board_boot_rec_t *rec = &board_boot_ledger[board_boot_num];
+
+        rec->ticks = ticks;
+        rec->id = id;
+        rec->arg = arg;
+        board_boot_num++;
+    }
+    else
+    {
+        board_boot_dropped++;
+    }
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Copy the boot ledger                                                     */
+/*--------------------------------------------------------------------------*/
+sc_err_t board_boot_dump(void *buf, uint32_t *size)
+{
+    sc_err_t err = SC_ERR_NONE;
+    board_boot_hdr_t *hdr = (board_boot_hdr_t *) buf;
+    board_boot_rec_t *rec = (board_boot_rec_t *) &hdr[1];
+
+    if (*size < U32(sizeof(board_boot_hdr_t)))
+    {
+        err = SC_ERR_PARM;
+    }
+    else
+    {
+        uint32_t room = (*size - U32(sizeof(board_boot_hdr_t)))
+            / U32(sizeof(board_boot_rec_t));
+        uint32_t count;
+        uint32_t idx;
+
+        /* Entries are never rewritten, only the count moves */
+        ENTER_CS;
+        count = MIN(board_boot_num, room);
+        hdr->dropped = board_boot_dropped + (board_boot_num - count);
+        EXIT_CS;
+
+        for (idx = 0U; idx < count; idx++)
+        {
+            rec[idx] = board_boot_ledger[idx];
+        }
+
+        hdr->magic = BOARD_BOOT_MAGIC;
+        hdr->count = count;
+        hdr->tick_hz = U32(SYSCTR_USEC_TO_TICKS64(1000000ULL));
+        *size = U32(sizeof(board_boot_hdr_t))
+            + (count * U32(sizeof(board_boot_rec_t)));
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Print the boot ledger                                                    */
+/*--------------------------------------------------------------------------*/
+void board_boot_report(void)
+{
+#ifdef DEBUG
+    static const char * const name[BOARD_BOOT_NUM_ID] =
+    {
+        "init", "ddr", "ddr done", "pmic", "pmic done", "config",
+        "partitions", "cpu"
+    };
+    uint64_t prev = 0ULL;
+    uint32_t idx;
+
+    always_print("Boot ledger:\n");
+    for (idx = 0U; idx < board_boot_num; idx++)
+    {
+        const board_boot_rec_t *rec = &board_boot_ledger[idx];
+        uint64_t usec = SYSCTR_TICKS_TO_USEC64(rec->ticks);
+
+        always_print("  %10u us (+%u) %s %u\n", U32(usec),
+            U32(usec - prev), (rec->id < BOARD_BOOT_NUM_ID)
+            ? name[rec->id] : "?", rec->arg);
+        prev = usec;
+    }
+    always_print("  dropped=%u\n", board_boot_dropped);
+#endif
+}
+
+/*--------------------------------------------------------------------------*/
+/* Check a client buffer passed by address                                  */
+/*--------------------------------------------------------------------------*/
+sc_err_t board_check_caller_buf(sc_rm_pt_t caller_pt, const void *buf,
+    uint32_t size)
+{
+    sc_err_t err = SC_ERR_NONE;
+    sc_rm_mr_t mr;
+    sc_faddr_t start = U64((uintptr_t) buf);
+
+    if (size == 0U)
+    {
+        err = SC_ERR_PARM;
+    }
+    else if (rm_find_memreg(caller_pt, &mr, start,
+        start + U64(size) - 1ULL) != SC_ERR_NONE)
+    {
+        err = SC_ERR_NOACCESS;
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Check the caller of a system control ioctl                               */
+/*--------------------------------------------------------------------------*/
+sc_err_t board_check_caller_ctrl(sc_rm_pt_t caller_pt, sc_rm_pt_t pt_boot)
+{
+    sc_err_t err = SC_ERR_NOACCESS;
+    sc_rm_pt_t pt = pt_boot;
+    uint32_t depth = 0U;
+
+    if (caller_pt == SC_PT)
+    {
+        err = SC_ERR_NONE;
+    }
+
+    /* Walk up from the boot partition */
+    while ((err != SC_ERR_NONE) && (depth < SC_RM_NUM_PARTITION))
+    {
+        sc_rm_pt_t parent = rm_get_partition_parent(pt);
+
+        if (pt == caller_pt)
+        {
+            err = SC_ERR_NONE;
+        }
+        else if (parent == pt)
+        {
+            break;
+        }
+        else
+        {
+            pt = parent;
+        }
+        depth++;
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Dispatch a batch of RPC calls                                            */
+/*--------------------------------------------------------------------------*/
+sc_err_t board_rpc_batch(sc_rm_pt_t caller_pt, sc_rsrc_t mu,
+    sc_rpc_msg_t *msgs, uint32_t *num)
+{
+    sc_err_t err = SC_ERR_NONE;
+    uint32_t count = *num;
+    uint32_t idx = 0U;
+
+    /* Whole array in one caller region, word aligned, before any copy */
+    if ((count == 0U) || (count > BOARD_RPC_BATCH_MAX)
+        || ((U32((uintptr_t) msgs) % U32(sizeof(uint32_t))) != 0U))
+    {
+        err = SC_ERR_PARM;
+    }
+    else
+    {
+        err = board_check_caller_buf(caller_pt, msgs,
+            count * U32(sizeof(sc_rpc_msg_t)));
+    }
+
+    while ((err == SC_ERR_NONE) && (idx < count))
+    {
+        /* Work on a local copy so the caller can't change it mid-call */
+        sc_rpc_msg_t msg = msgs[idx];
+        sc_rpc_svc_t svc = RPC_SVC(&msg);
+        uint8_t func = RPC_FUNC(&msg);
+        uint64_t start;
+
+        if ((RPC_VER(&msg) != SC_RPC_VERSION) || (RPC_SIZE(&msg) == 0U)
+            || (RPC_SIZE(&msg) > SC_RPC_MAX_MSG))
+        {
+            err = SC_ERR_PARM;
+            break;
+        }
+
+        /* MISC is excluded so a batch can't nest another board ioctl */
+        start = rpc_rec_start();
+        switch (svc)
+        {
+            case SC_RPC_SVC_PM :
+                pm_dispatch(caller_pt, mu, &msg);
+                break;
+            case SC_RPC_SVC_RM :
+                rm_dispatch(caller_pt, mu, &msg);
+                break;
+            case SC_RPC_SVC_PAD :
+                pad_dispatch(caller_pt, mu, &msg);
+                break;
+            case SC_RPC_SVC_TIMER :
+                timer_dispatch(caller_pt, mu, &msg);
+                break;
+            case SC_RPC_SVC_IRQ :
+                irq_dispatch(caller_pt, mu, &msg);
+                break;
+            default :
+                err = SC_ERR_PARM;
+                break;
+        }
+
+        if (err == SC_ERR_NONE)
+        {
+            msgs[idx] = msg;
+            idx++;
+
+            /* Stop on first error */
+            if (rpc_batch_failed(&msg, svc) != SC_FALSE)
+            {
+                err = (sc_err_t) RPC_R8(&msg);
+            }
+            rpc_rec_log(start, caller_pt, mu, U8(svc), func, err);
+        }
+    }
+
+    *num = idx;
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Check if a batched call returned an error                                */
+/*--------------------------------------------------------------------------*/
+static sc_bool_t rpc_batch_failed(const sc_rpc_msg_t *msg, sc_rpc_svc_t svc)
+{
+    sc_bool_t failed = U2B(RPC_R8(msg));
+    uint8_t func = RPC_FUNC(msg);
+
+    /* These calls return a boolean in place of an error code */
+    if (svc == SC_RPC_SVC_PM)
+    {
+        if (func == U8(PM_FUNC_IS_PARTITION_STARTED))
+        {
+            failed = SC_FALSE;
+        }
+    }
+    else if (svc == SC_RPC_SVC_RM)
+    {
+        if ((func == U8(RM_FUNC_IS_RESOURCE_OWNED))
+            || (func == U8(RM_FUNC_IS_RESOURCE_MASTER))
+            || (func == U8(RM_FUNC_IS_RESOURCE_PERIPHERAL))
+            || (func == U8(RM_FUNC_IS_MEMREG_OWNED))
+            || (func == U8(RM_FUNC_IS_PAD_OWNED)))
+        {
+            failed = SC_FALSE;
+        }
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    return failed;
 }
 
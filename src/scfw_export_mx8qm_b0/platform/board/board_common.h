@@ -49,8 +49,210 @@
 
 /* Includes */
 
+#include "main/rpc.h"
+#include "main/sched.h"
+#include "svc/irq/api.h"
+#include "svc/rm/api.h"
+
 /* Defines */
 
+/*! Max number of calls in one RPC batch */
+#define BOARD_RPC_BATCH_MAX     32U
+
+/*! Default partition notification coalescing window in mS (0 = off) */
+#ifndef BOARD_NOTIFY_WINDOW_MS
+    #define BOARD_NOTIFY_WINDOW_MS  0U
+#endif
+
+/*! IRQ groups routed through board_notify() by the ss_irq_trigger() wrap */
+#ifndef BOARD_NOTIFY_GROUPS
+    #define BOARD_NOTIFY_GROUPS     (BIT(SC_IRQ_GROUP_TEMP) \
+                                    | BIT(SC_IRQ_GROUP_WDOG) \
+                                    | BIT(SC_IRQ_GROUP_RTC))
+#endif
+
+/*! IRQ groups always delivered without coalescing */
+#ifndef BOARD_NOTIFY_IMMEDIATE
+    #define BOARD_NOTIFY_IMMEDIATE  BIT(SC_IRQ_GROUP_WAKE)
+#endif
+
+/*!
+ * Priority of the board worker (PendSV). The lowest priority by default,
+ * so work only runs once no other handler is active.
+ */
+#ifndef BOARD_WORK_PRIO
+    #define BOARD_WORK_PRIO     SC_SCHED_PRIO_NOPREEMPT_VERY_LOW
+#endif
+
+/*! Number of delay call sites tracked */
+#ifndef BOARD_DELAY_SITES
+    #define BOARD_DELAY_SITES   16U
+#endif
+
+/*! Number of boot ledger entries */
+#ifndef BOARD_BOOT_LEDGER_MAX
+    #define BOARD_BOOT_LEDGER_MAX   32U
+#endif
+
+/*!
+ * @name Boot ledger checkpoints
+ */
+/*@{*/
+#define BOARD_BOOT_INIT         0U  /*!< board_init(), arg = phase */
+#define BOARD_BOOT_DDR          1U  /*!< DDR init start */
+#define BOARD_BOOT_DDR_DONE     2U  /*!< DDR init and training done,
+                                         arg = error */
+#define BOARD_BOOT_PMIC         3U  /*!< PMIC init start */
+#define BOARD_BOOT_PMIC_DONE    4U  /*!< PMIC init done, arg = device ID */
+#define BOARD_BOOT_CONFIG       5U  /*!< System config start */
+#define BOARD_BOOT_PART         6U  /*!< Partition build done */
+#define BOARD_BOOT_CPU          7U  /*!< CPU start, arg = resource */
+#define BOARD_BOOT_NUM_ID       8U
+/*@}*/
+
+/*! Boot ledger dump marker ("BOOT") */
+#define BOARD_BOOT_MAGIC        0x544F4F42U
+
+/*!
+ * @name Delay accounting
+ *
+ * In a SIMU build (or with BOARD_DELAY_STATS) delays are recorded per
+ * call site. SIMU delays only advance the virtual board counter.
+ */
+/*@{*/
+#if defined(SIMU) || defined(BOARD_DELAY_STATS)
+    #define BOARD_DELAY(usec)           board_delay(U32(usec), __FILE__, \
+                                            U32(__LINE__))
+    #define BOARD_DELAY_RECORD(usec)    board_delay_record(U32(usec), \
+                                            __FILE__, U32(__LINE__))
+#else
+    #define BOARD_DELAY(usec)           SystemTimeDelay(usec)
+    #define BOARD_DELAY_RECORD(usec)    NOP
+#endif
+/*@}*/
+
+/*!
+ * @name Binary debug log
+ *
+ * With BOARD_LOG_BINARY defined, board_printf() stores the format
+ * string address, a SYSCTR timestamp and the raw arguments in a RAM
+ * ring instead of formatting. The board tick drains the ring to the
+ * debug UART as text frames which bin/scfw_log.py expands using the
+ * format strings in the ELF.
+ */
+/*@{*/
+#ifndef BOARD_LOG_RING_WORDS
+    #define BOARD_LOG_RING_WORDS    512U    /*!< Ring size, power of 2 */
+#endif
+#ifndef BOARD_LOG_MAX_ARGS
+    #define BOARD_LOG_MAX_ARGS      8U      /*!< Argument words per call */
+#endif
+#ifndef BOARD_LOG_DRAIN_MAX
+    #define BOARD_LOG_DRAIN_MAX     8U      /*!< Records drained per tick */
+#endif
+#define BOARD_LOG_HDR_WORDS         3U      /*!< Format, time, arg count */
+/*@}*/
+
+/* Types */
+
+/*!
+ * Board timer callback. Called from the board tick, or from the board
+ * worker for a work item.
+ */
+typedef void (*board_timer_cb_t)(void);
+
+/*!
+ * Board timer. Owned by the caller, linked into a list sorted by
+ * deadline while armed.
+ */
+typedef struct board_timer
+{
+    struct board_timer *next;   /*!< Next timer by deadline */
+    board_timer_cb_t cb;        /*!< Callback */
+    uint64_t deadline;          /*!< SYSCTR tick of next expiry */
+    uint32_t period_ms;         /*!< Reload period (0 = one-shot) */
+    sc_bool_t active;           /*!< Armed flag */
+} board_timer_t;
+
+/*!
+ * Board work item. Owned by the caller, linked into a queue while
+ * posted and run once per post.
+ */
+typedef struct board_work
+{
+    struct board_work *next;    /*!< Next queued item */
+    board_timer_cb_t cb;        /*!< Work function */
+    sc_bool_t queued;           /*!< Posted and not yet run */
+} board_work_t;
+
+/*!
+ * Queue of board work items
+ */
+typedef struct
+{
+    board_work_t *head;         /*!< Next item to run */
+    board_work_t *tail;         /*!< Last item posted */
+} board_work_q_t;
+
+/*!
+ * Deferred interrupt statistics. Times are from the top half raising
+ * the work to the bottom half completing it.
+ */
+typedef struct
+{
+    uint32_t irqs;              /*!< Top half runs */
+    uint32_t runs;              /*!< Bottom half runs */
+    uint32_t isr_ticks;         /*!< Last top half time in SYSCTR ticks */
+    uint32_t isr_max_ticks;     /*!< Longest top half time */
+    uint32_t lat_usec;          /*!< Last raise to completion in uS */
+    uint32_t lat_max_usec;      /*!< Longest raise to completion */
+} board_irq_stats_t;
+
+/*!
+ * Deferred interrupt. The top half masks the line and posts the bottom
+ * half to the board worker, which unmasks the line again when done.
+ */
+typedef struct
+{
+    IRQn_Type irq;              /*!< Interrupt line */
+    board_timer_cb_t work;      /*!< Bottom half */
+    board_work_t item;          /*!< Work item */
+    uint64_t raised;            /*!< SYSCTR tick of the top half */
+    board_irq_stats_t stats;    /*!< Statistics */
+} board_irq_defer_t;
+
+/*!
+ * Partition notification statistics
+ */
+typedef struct
+{
+    uint32_t events;            /*!< Notifications posted */
+    uint32_t doorbells;         /*!< ss_irq_trigger() calls made */
+    uint32_t immediate;         /*!< Posted with immediate delivery */
+    uint32_t windows;           /*!< Coalescing windows opened */
+} board_notify_stats_t;
+
+/*!
+ * Boot ledger entry
+ */
+typedef struct
+{
+    uint64_t ticks;             /*!< SYSCTR tick (virtual in SIMU) */
+    uint32_t id;                /*!< Checkpoint (BOARD_BOOT_*) */
+    uint32_t arg;               /*!< Checkpoint argument */
+} board_boot_rec_t;
+
+/*!
+ * Boot ledger dump header, followed by \a count entries
+ */
+typedef struct
+{
+    uint32_t magic;             /*!< BOARD_BOOT_MAGIC */
+    uint32_t count;             /*!< Entries that follow */
+    uint32_t dropped;           /*!< Checkpoints after the ledger filled */
+    uint32_t tick_hz;           /*!< SYSCTR frequency */
+} board_boot_hdr_t;
+
 /* External variables */
 
 /*! Shim debug variable (to allow object package config */
@@ -114,6 +316,21 @@ void board_stdio(void);
  */
 void board_printf(const char *fmt, ...);
 
+#if defined(DEBUG) && defined(BOARD_LOG_BINARY)
+/*!
+ * Drain records from the binary debug log to the debug UART.
+ *
+ * @param[in]     max           max number of records to drain
+ *
+ * Each record is written as one line "#L" followed by the record
+ * words in hex. A "#D" line reports records dropped because the
+ * ring was full. Records still being written end the drain early.
+ *
+ * @return Returns the number of records drained.
+ */
+uint32_t board_log_drain(uint32_t max);
+#endif
+
 /*!
  * Enable/disable the DDR periodic tick.
  *
@@ -132,9 +349,260 @@ void board_ddr_derate_periodic_enable(sc_bool_t enb);
  * Common function to tick the board.
  *
  * @param[in]     msec          number of mS to increment
+ *
+ * Only timers whose deadline has passed are run. The common
+ * tick returns after one compare when nothing is due.
  */
 void board_common_tick(uint16_t msec);
 
+/*!
+ * Arm a board timer. A timer that is already armed is restarted.
+ *
+ * @param[in,out] timer         timer to arm
+ * @param[in]     cb            callback to run on expiry
+ * @param[in]     delay_ms      time to first expiry in mS
+ * @param[in]     period_ms     reload period in mS (0 = one-shot)
+ */
+void board_timer_start(board_timer_t *timer, board_timer_cb_t cb,
+    uint32_t delay_ms, uint32_t period_ms);
+
+/*!
+ * Disarm a board timer.
+ *
+ * @param[in,out] timer         timer to disarm
+ */
+void board_timer_stop(board_timer_t *timer);
+
+/*!
+ * Return the time until the earliest board timer expires. The SYSCTR
+ * wake armed before the SCU enters low power is limited to this, so
+ * board timers are not held off until the next unrelated wakeup.
+ *
+ * @return Returns time in uS (UINT32_MAX if no timer is armed).
+ */
+uint32_t board_timer_next_usec(void);
+
+/*!
+ * Queue work for the board worker. The worker is the PendSV exception
+ * at BOARD_WORK_PRIO, so the work runs once the caller and any other
+ * handler at or above that priority have returned, never inside them.
+ * Posting an item that is still queued does nothing.
+ *
+ * @param[in,out] work          work item
+ * @param[in]     cb            work function
+ */
+void board_work_post(board_work_t *work, board_timer_cb_t cb);
+
+/*!
+ * Queue work for RPC context. The work runs right after the next RPC
+ * has been dispatched, in the context that dispatched it, so it is
+ * serialized with the services and may call them. The response to that
+ * RPC waits for the work. Nothing runs the work while no RPC arrives.
+ *
+ * @param[in,out] work          work item
+ * @param[in]     cb            work function
+ */
+void board_rpc_work_post(board_work_t *work, board_timer_cb_t cb);
+
+/*!
+ * Run the work queued for RPC context. Called by the sc_rpc_dispatch()
+ * wrap after each dispatched RPC.
+ */
+void board_rpc_work_run(void);
+
+/*!
+ * Set up a deferred interrupt and enable the line.
+ *
+ * @param[out]    defer         deferred interrupt to set up
+ * @param[in]     irq           interrupt line
+ * @param[in]     work          bottom half, must call board_irq_defer_done()
+ */
+void board_irq_defer_init(board_irq_defer_t *defer, IRQn_Type irq,
+    board_timer_cb_t work);
+
+/*!
+ * Top half. Called from the interrupt handler to mask the line and
+ * post the bottom half to the board worker. Interrupts arriving before the bottom half
+ * runs are coalesced into one run.
+ *
+ * @param[in,out] defer         deferred interrupt
+ */
+void board_irq_defer_raise(board_irq_defer_t *defer);
+
+/*!
+ * Complete the bottom half. Records the latency and unmasks the line.
+ *
+ * @param[in,out] defer         deferred interrupt
+ */
+void board_irq_defer_done(board_irq_defer_t *defer);
+
+/*!
+ * Post an IRQ service notification. The first notification opens a
+ * coalescing window and is delivered at once. Later notifications in
+ * the window are merged per partition and group, and delivered as one
+ * ss_irq_trigger() each when the window closes. Can be called from an
+ * interrupt handler.
+ *
+ * Coalescing is off until a window is set with board_notify_config().
+ * Linking with -Wl,--wrap=ss_irq_trigger also routes the
+ * BOARD_NOTIFY_GROUPS notifications raised by the SC services through
+ * here.
+ *
+ * @param[in]     group         IRQ group
+ * @param[in]     irq           mask of IRQ status bits in the group
+ * @param[in]     pt            partition to notify (or SC_PT_ALL)
+ */
+void board_notify(sc_irq_group_t group, uint32_t irq, sc_rm_pt_t pt);
+
+/*!
+ * Set the coalescing window. Pending notifications are delivered and
+ * the statistics are cleared.
+ *
+ * @param[in]     window_ms     window in mS (0 = deliver immediately)
+ */
+void board_notify_config(uint32_t window_ms);
+
+/*!
+ * Select the IRQ groups a partition wants delivered immediately.
+ * Broadcasts (SC_PT_ALL) are immediate if any partition selected
+ * the group.
+ *
+ * @param[in]     pt            partition
+ * @param[in]     groups        mask of BIT(group)
+ */
+void board_notify_immediate(sc_rm_pt_t pt, uint32_t groups);
+
+/*!
+ * Deliver all pending notifications.
+ *
+ * @return Returns the number of ss_irq_trigger() calls made.
+ */
+uint32_t board_notify_flush(void);
+
+/*!
+ * Return notification statistics.
+ *
+ * @param[out]    stats         statistics
+ */
+void board_notify_get_stats(board_notify_stats_t *stats);
+
+/*!
+ * Return the board time base. This is the SYSCTR counter on hardware
+ * and a virtual counter advanced by BOARD_DELAY() and the board tick in
+ * a SIMU build.
+ *
+ * @return Returns the counter in SYSCTR ticks.
+ */
+uint64_t board_get_counter64(void);
+
+#if defined(SIMU) || defined(BOARD_DELAY_STATS)
+/*!
+ * Delay and record the time against the call site. Use BOARD_DELAY().
+ *
+ * @param[in]     usec          delay in uS
+ * @param[in]     file          call site file
+ * @param[in]     line          call site line
+ */
+void board_delay(uint32_t usec, const char *file, uint32_t line);
+
+/*!
+ * Record time spent busy-polling against the call site. Use
+ * BOARD_DELAY_RECORD().
+ *
+ * @param[in]     usec          time in uS
+ * @param[in]     file          call site file
+ * @param[in]     line          call site line
+ */
+void board_delay_record(uint32_t usec, const char *file, uint32_t line);
+
+/*!
+ * Print the per call site delay report.
+ */
+void board_delay_report(void);
+#endif
+
+/*!
+ * Record a boot checkpoint in the boot ledger. Checkpoints after the
+ * ledger is full are counted as dropped.
+ *
+ * @param[in]     id            checkpoint (BOARD_BOOT_*)
+ * @param[in]     arg           checkpoint argument
+ */
+void board_boot_mark(uint32_t id, uint32_t arg);
+
+/*!
+ * Copy the boot ledger to a buffer.
+ *
+ * @param[out]    buf           buffer for a board_boot_hdr_t and entries
+ * @param[in,out] size          buffer size, returns bytes written
+ *
+ * @return Returns an error code (SC_ERR_NONE = success).
+ *
+ * Return errors:
+ * - SC_ERR_PARM if \a size is too small for the header
+ */
+sc_err_t board_boot_dump(void *buf, uint32_t *size);
+
+/*!
+ * Print the boot ledger with the time since the previous checkpoint.
+ */
+void board_boot_report(void);
+
+/*!
+ * Check that a buffer passed by address in a board ioctl lies wholly
+ * inside one memory region owned by the caller. A buffer spanning two
+ * adjacent regions of the caller fails.
+ *
+ * @param[in]     caller_pt     handle of caller partition
+ * @param[in]     buf           buffer address
+ * @param[in]     size          buffer size in bytes
+ *
+ * @return Returns an error code (SC_ERR_NONE = success).
+ *
+ * Return errors:
+ * - SC_ERR_PARM if \a size is 0,
+ * - SC_ERR_NOACCESS if \a buf is not in a region owned by the caller
+ */
+sc_err_t board_check_caller_buf(sc_rm_pt_t caller_pt, const void *buf,
+    uint32_t size);
+
+/*!
+ * Check that the caller of a board ioctl that changes system wide
+ * state is the SC or the boot partition or one of its parents.
+ *
+ * @param[in]     caller_pt     handle of caller partition
+ * @param[in]     pt_boot       boot partition
+ *
+ * @return Returns an error code (SC_ERR_NONE = success, SC_ERR_NOACCESS
+ *         = caller not allowed).
+ */
+sc_err_t board_check_caller_ctrl(sc_rm_pt_t caller_pt, sc_rm_pt_t pt_boot);
+
+/*!
+ * Dispatch a batch of RPC calls received in one board ioctl.
+ *
+ * @param[in]     caller_pt     handle of caller partition
+ * @param[in]     mu            receiving MU via RPC/IPC
+ * @param[in,out] msgs          array of RPC messages, one per call
+ * @param[in,out] num           number of calls, returns number dispatched
+ *
+ * Calls are dispatched in order to the PM, RM, PAD, TIMER and IRQ
+ * services exactly as if they had arrived over the MU. Each message
+ * is overwritten with its response. Dispatch stops after the first
+ * call that returns an error. The array must be word aligned and lie
+ * wholly inside one memory region owned by the caller. Both are checked
+ * before any message is read.
+ *
+ * @return Returns the error of the failing call (SC_ERR_NONE = success).
+ *
+ * Return errors:
+ * - SC_ERR_PARM if \a num is out of range, \a msgs is not word aligned
+ *   or a message is malformed,
+ * - SC_ERR_NOACCESS if \a msgs is not in a region owned by the caller
+ */
+sc_err_t board_rpc_batch(sc_rm_pt_t caller_pt, sc_rsrc_t mu,
+    sc_rpc_msg_t *msgs, uint32_t *num);
+
 /**@}*/
 
 #endif /* SC_BOARD_COMMON_H */
@@ -0,0 +1,350 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Implementation of the DDR bandwidth monitor.
+ */
+/*==========================================================================*/
+
+/* Includes */
+
+#include "main/main.h"
+#include "main/board.h"
+#include "drivers/sysctr/fsl_sysctr.h"
+#include "board/ddr_perf.h"
+
+/* Local Defines */
+
+/*!
+ * @name DRC performance counter control fields
+ */
+/*@{*/
+#define DRC_PERF_CR(X, N)       (DRC_PERF_COUNTER_BASE_ADDR(X) + (U32(N) * 4U))
+#define DRC_PERF_DR(X, N)       (DRC_PERF_COUNTER_BASE_ADDR(X) + 0x20U \
+                                    + (U32(N) * 4U))
+#define DRC_PERF_CR_CLEAR       0x2U
+#define DRC_PERF_CR_EN          0x4U
+#define DRC_PERF_CR_CSV_SHIFT   24U
+/*@}*/
+
+/*!
+ * @name DRC performance counter events
+ */
+/*@{*/
+#define DRC_PERF_EV_CYCLES      0x00U
+#define DRC_PERF_EV_RD_CMD      0x20U
+#define DRC_PERF_EV_WR_CMD      0x21U
+#define DRC_PERF_EV_HP_NOCREDIT 0x24U
+#define DRC_PERF_EV_LP_NOCREDIT 0x26U
+#define DRC_PERF_EV_ACTIVATE    0x32U
+/*@}*/
+
+#define DRC_PERF_NUM_CNT        4U
+
+/*! Counter shared by the multiplexed events */
+#define DRC_PERF_MUX_CNT        (DRC_PERF_NUM_CNT - 1U)
+
+/* Local Functions */
+
+static uint32_t ddr_perf_ratio(uint32_t cnt, uint32_t cycles);
+static void ddr_perf_update(void);
+static void ddr_perf_restart(uint32_t drc, uint32_t mux);
+static void ddr_perf_tick(void);
+
+/* Local Variables */
+
+/*! Event counted by each fixed counter, counter 0 must count cycles */
+static const uint8_t ddr_perf_event[DRC_PERF_MUX_CNT] =
+{
+    DRC_PERF_EV_CYCLES,
+    DRC_PERF_EV_RD_CMD,
+    DRC_PERF_EV_WR_CMD
+};
+
+/*! Events counted in turn by the last counter (DDR_PERF_MUX_*) */
+static const uint8_t ddr_perf_mux_event[DDR_PERF_NUM_MUX] =
+{
+    DRC_PERF_EV_ACTIVATE,
+    DRC_PERF_EV_HP_NOCREDIT,
+    DRC_PERF_EV_LP_NOCREDIT
+};
+
+static board_timer_t ddr_perf_timer;
+static ddr_perf_window_t ddr_perf_win[DDR_PERF_NUM_DRC];
+static uint64_t ddr_perf_last;
+static uint32_t ddr_perf_mux;
+static sc_bool_t ddr_perf_enabled = SC_FALSE;
+static sc_bool_t ddr_perf_paused = SC_FALSE;
+
+/*--------------------------------------------------------------------------*/
+/* Start or stop sampling                                                   */
+/*--------------------------------------------------------------------------*/
+void ddr_perf_enable(sc_bool_t enb)
+{
+    ddr_perf_enabled = enb;
+    ddr_perf_update();
+}
+
+/*--------------------------------------------------------------------------*/
+/* Pause sampling while the DRCs are unavailable                            */
+/*--------------------------------------------------------------------------*/
+void ddr_perf_pause(sc_bool_t pause)
+{
+    ddr_perf_paused = pause;
+    ddr_perf_update();
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get bandwidth statistics                                                 */
+/*--------------------------------------------------------------------------*/
+sc_err_t ddr_perf_get_stats(uint32_t drc, ddr_perf_stats_t *stats)
+{
+    sc_err_t err = SC_ERR_NONE;
+
+    if (drc >= DDR_PERF_NUM_DRC)
+    {
+        err = SC_ERR_PARM;
+    }
+    else
+    {
+        ENTER_CS;
+        ddr_perf_window_stats(&ddr_perf_win[drc], stats);
+        EXIT_CS;
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Add a sample to a window                                                 */
+/*--------------------------------------------------------------------------*/
+void ddr_perf_window_add(ddr_perf_window_t *win,
+    const ddr_perf_sample_t *sample)
+{
+    ddr_perf_sample_t *slot = &win->sample[win->idx];
+
+    /* Evict the oldest sample */
+    if (win->num == DDR_PERF_WINDOW)
+    {
+        win->usec -= slot->usec;
+        win->cycles -= slot->cycles;
+        win->rd_cmd -= slot->rd_cmd;
+        win->wr_cmd -= slot->wr_cmd;
+        win->mux_cnt[slot->mux] -= slot->mux_cnt;
+        win->mux_usec[slot->mux] -= slot->usec;
+        win->mux_cycles[slot->mux] -= slot->cycles;
+    }
+    else
+    {
+        win->num++;
+    }
+
+    *slot = *sample;
+    win->usec += sample->usec;
+    win->cycles += sample->cycles;
+    win->rd_cmd += sample->rd_cmd;
+    win->wr_cmd += sample->wr_cmd;
+    win->mux_cnt[sample->mux] += sample->mux_cnt;
+    win->mux_usec[sample->mux] += sample->usec;
+    win->mux_cycles[sample->mux] += sample->cycles;
+
+    win->idx = (win->idx + 1U) % DDR_PERF_WINDOW;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Convert a window to bandwidth statistics                                 */
+/*--------------------------------------------------------------------------*/
+void ddr_perf_window_stats(const ddr_perf_window_t *win,
+    ddr_perf_stats_t *stats)
+{
+    uint64_t usec = U64(win->usec);
+    uint64_t act_usec = U64(win->mux_usec[DDR_PERF_MUX_ACT]);
+
+    stats->window_ms = win->usec / 1000U;
+
+    if (usec == 0ULL)
+    {
+        stats->rd_kbps = 0U;
+        stats->wr_kbps = 0U;
+    }
+    else
+    {
+        /* bytes / usec * 1000000 / 1024 */
+        stats->rd_kbps = U32((U64(win->rd_cmd) * DDR_PERF_BYTES_PER_CMD
+            * 1000000ULL) / (usec * 1024ULL));
+        stats->wr_kbps = U32((U64(win->wr_cmd) * DDR_PERF_BYTES_PER_CMD
+            * 1000000ULL) / (usec * 1024ULL));
+    }
+
+    /* Activates are only counted part of the time */
+    if (act_usec == 0ULL)
+    {
+        stats->act_per_ms = 0U;
+    }
+    else
+    {
+        stats->act_per_ms = U32((U64(win->mux_cnt[DDR_PERF_MUX_ACT])
+            * 1000ULL) / act_usec);
+    }
+
+    if (win->cycles == 0U)
+    {
+        stats->util = 0U;
+    }
+    else
+    {
+        uint64_t busy = (U64(win->rd_cmd) + U64(win->wr_cmd))
+            * DDR_PERF_CYCLES_PER_CMD;
+
+        stats->util = U32((busy * 1000ULL) / U64(win->cycles));
+        if (stats->util > 1000U)
+        {
+            stats->util = 1000U;
+        }
+    }
+
+    stats->hp_stall = ddr_perf_ratio(win->mux_cnt[DDR_PERF_MUX_HP_STALL],
+        win->mux_cycles[DDR_PERF_MUX_HP_STALL]);
+    stats->lp_stall = ddr_perf_ratio(win->mux_cnt[DDR_PERF_MUX_LP_STALL],
+        win->mux_cycles[DDR_PERF_MUX_LP_STALL]);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Start or stop the sample timer                                           */
+/*--------------------------------------------------------------------------*/
+static void ddr_perf_update(void)
+{
+    uint32_t drc;
+
+    if ((ddr_perf_enabled == SC_FALSE) || (ddr_perf_paused != SC_FALSE))
+    {
+        board_timer_stop(&ddr_perf_timer);
+    }
+    else if (ddr_perf_timer.active == SC_FALSE)
+    {
+        static const ddr_perf_window_t zero = {0U};
+
+        /* Old windows span the gap, start over */
+        ddr_perf_mux = DDR_PERF_MUX_ACT;
+        for (drc = 0U; drc < DDR_PERF_NUM_DRC; drc++)
+        {
+            ENTER_CS;
+            ddr_perf_win[drc] = zero;
+            EXIT_CS;
+
+            ddr_perf_restart(drc, ddr_perf_mux);
+        }
+        ddr_perf_last = board_get_counter64();
+
+        board_timer_start(&ddr_perf_timer, ddr_perf_tick,
+            DDR_PERF_PERIOD_MS, DDR_PERF_PERIOD_MS);
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Clear and restart the counters of a DRC                                  */
+/*--------------------------------------------------------------------------*/
+static void ddr_perf_restart(uint32_t drc, uint32_t mux)
+{
+    uint32_t cnt;
+
+    for (cnt = 0U; cnt < DRC_PERF_NUM_CNT; cnt++)
+    {
+        uint32_t ev = (cnt == DRC_PERF_MUX_CNT) ? ddr_perf_mux_event[mux]
+            : ddr_perf_event[cnt];
+
+        WRITE32(DRC_PERF_CR(drc, cnt), 0U);
+        WRITE32(DRC_PERF_CR(drc, cnt), DRC_PERF_CR_EN | DRC_PERF_CR_CLEAR
+            | (ev << DRC_PERF_CR_CSV_SHIFT));
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Sample all DRCs, called from the board timer                             */
+/*--------------------------------------------------------------------------*/
+static void ddr_perf_tick(void)
+{
+    uint64_t now = board_get_counter64();
+    ddr_perf_sample_t sample;
+    uint32_t next = (ddr_perf_mux + 1U) % DDR_PERF_NUM_MUX;
+    uint32_t drc;
+
+    sample.usec = U32(SYSCTR_TICKS_TO_USEC64(now - ddr_perf_last));
+    sample.mux = ddr_perf_mux;
+    ddr_perf_last = now;
+
+    for (drc = 0U; drc < DDR_PERF_NUM_DRC; drc++)
+    {
+        /* Read and clear each period so the 32-bit counters never wrap */
+        sample.cycles = READ32(DRC_PERF_DR(drc, 0U));
+        sample.rd_cmd = READ32(DRC_PERF_DR(drc, 1U));
+        sample.wr_cmd = READ32(DRC_PERF_DR(drc, 2U));
+        sample.mux_cnt = READ32(DRC_PERF_DR(drc, DRC_PERF_MUX_CNT));
+        ddr_perf_restart(drc, next);
+
+        ENTER_CS;
+        ddr_perf_window_add(&ddr_perf_win[drc], &sample);
+        EXIT_CS;
+    }
+
+    ddr_perf_mux = next;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Event cycles per 1000 controller cycles                                  */
+/*--------------------------------------------------------------------------*/
+static uint32_t ddr_perf_ratio(uint32_t cnt, uint32_t cycles)
+{
+    uint32_t ratio = 0U;
+
+    if (cycles != 0U)
+    {
+        ratio = U32((U64(cnt) * 1000ULL) / U64(cycles));
+        if (ratio > 1000U)
+        {
+            ratio = 1000U;
+        }
+    }
+
+    return ratio;
+}
+
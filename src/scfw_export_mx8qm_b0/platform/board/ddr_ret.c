@@ -0,0 +1,247 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Implementation of the board DDR retention engine.
+ */
+/*==========================================================================*/
+
+/* Includes */
+
+#include "main/main.h"
+#include "main/board.h"
+#include "drivers/sysctr/fsl_sysctr.h"
+#include "board/board_common.h"
+#include "board/ddr_ret.h"
+
+/* Local Defines */
+
+/* Nanoseconds per SYSCTR tick (8 MHz) */
+#define DDR_RET_TICK_NS     125ULL
+
+/* Local Types */
+
+/* Local Functions */
+
+static void ddr_ret_copy(uint32_t *dst, uint32_t dst_step,
+    const uint32_t *src, uint32_t src_step, uint32_t words);
+
+/* Local Variables */
+
+/* Blocks live in the statistics, nothing else describes them */
+static ddr_ret_stats_t ddr_ret_stats;
+static uint32_t *ddr_ret_buf = NULL;
+
+/*--------------------------------------------------------------------------*/
+/* Compact runs into blocks                                                 */
+/*--------------------------------------------------------------------------*/
+sc_err_t ddr_ret_init(const ddr_ret_run_t *run, uint32_t num_run,
+    uint32_t *buf, uint32_t buf_words)
+{
+    static const ddr_ret_stats_t zero = {0U};
+    ddr_ret_stats_t *st = &ddr_ret_stats;
+    sc_err_t err = SC_ERR_NONE;
+    uint32_t r;
+
+    *st = zero;
+    ddr_ret_buf = NULL;
+    st->runs = num_run;
+
+    for (r = 0U; (r < num_run) && (err == SC_ERR_NONE); r++)
+    {
+        uint32_t stride = (run[r].stride == 0U) ? 4U : run[r].stride;
+        uint32_t n;
+
+        /* Words must stay aligned */
+        if ((stride > 0xFFFFU) || ((stride & 3U) != 0U)
+            || ((run[r].base & 3U) != 0U))
+        {
+            err = SC_ERR_PARM;
+        }
+
+        for (n = 0U; (n < run[r].len) && (err == SC_ERR_NONE); n++)
+        {
+            uint32_t addr = run[r].base + (n * stride);
+
+            if ((run[r].mask & BIT(n % 32U)) == 0U)
+            {
+                st->skipped++;
+            }
+            else
+            {
+                ddr_ret_blk_t *blk = &st->blk[(st->blocks == 0U) ? 0U
+                    : (st->blocks - 1U)];
+
+                /* Continue the last block if evenly spaced */
+                if ((st->blocks != 0U) && (U32(blk->stride) == stride)
+                    && (U32(blk->words) < 0xFFFFU)
+                    && (addr == (blk->addr + (U32(blk->words) * stride))))
+                {
+                    blk->words++;
+                }
+                else if (st->blocks < DDR_RET_MAX_BLK)
+                {
+                    blk = &st->blk[st->blocks];
+                    blk->addr = addr;
+                    blk->words = 1U;
+                    blk->stride = U16(stride);
+                    st->blocks++;
+                }
+                else
+                {
+                    err = SC_ERR_UNAVAILABLE;
+                }
+                st->words++;
+            }
+        }
+    }
+
+    if ((err == SC_ERR_NONE) && (st->words > buf_words))
+    {
+        err = SC_ERR_UNAVAILABLE;
+    }
+
+    /* Retain all or nothing */
+    if (err == SC_ERR_NONE)
+    {
+        ddr_ret_buf = buf;
+    }
+    else
+    {
+        st->blocks = 0U;
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Save the blocks                                                          */
+/*--------------------------------------------------------------------------*/
+void ddr_ret_save(void)
+{
+    ddr_ret_stats_t *st = &ddr_ret_stats;
+    uint64_t start = board_get_counter64();
+    uint64_t t = start;
+    uint32_t *p = ddr_ret_buf;
+    uint32_t b;
+
+    for (b = 0U; b < st->blocks; b++)
+    {
+        ddr_ret_blk_t *blk = &st->blk[b];
+        uint64_t now;
+
+        ddr_ret_copy(p, 1U, (const uint32_t *) blk->addr,
+            U32(blk->stride) / 4U, U32(blk->words));
+        p = &p[blk->words];
+
+        now = board_get_counter64();
+        blk->save_ns = (now - t) * DDR_RET_TICK_NS;
+        t = now;
+    }
+
+    st->saves++;
+    st->save_us = U32(SYSCTR_TICKS_TO_USEC64(t - start));
+}
+
+/*--------------------------------------------------------------------------*/
+/* Restore the blocks                                                       */
+/*--------------------------------------------------------------------------*/
+void ddr_ret_restore(void)
+{
+    ddr_ret_stats_t *st = &ddr_ret_stats;
+    uint64_t start = board_get_counter64();
+    uint64_t t = start;
+    const uint32_t *p = ddr_ret_buf;
+    uint32_t b;
+
+    for (b = 0U; b < st->blocks; b++)
+    {
+        ddr_ret_blk_t *blk = &st->blk[b];
+        uint64_t now;
+
+        ddr_ret_copy((uint32_t *) blk->addr, U32(blk->stride) / 4U, p, 1U,
+            U32(blk->words));
+        p = &p[blk->words];
+
+        now = board_get_counter64();
+        blk->restore_ns = (now - t) * DDR_RET_TICK_NS;
+        t = now;
+    }
+
+    st->restores++;
+    st->restore_us = U32(SYSCTR_TICKS_TO_USEC64(t - start));
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get engine statistics                                                    */
+/*--------------------------------------------------------------------------*/
+void ddr_ret_get_stats(ddr_ret_stats_t *stats)
+{
+    *stats = ddr_ret_stats;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Copy words, four at a time when both sides are adjacent                  */
+/*--------------------------------------------------------------------------*/
+static void ddr_ret_copy(uint32_t *dst, uint32_t dst_step,
+    const uint32_t *src, uint32_t src_step, uint32_t words)
+{
+    uint32_t n = 0U;
+
+    if ((dst_step == 1U) && (src_step == 1U))
+    {
+        for (; (n + 4U) <= words; n += 4U)
+        {
+            uint32_t a = src[n];
+            uint32_t b = src[n + 1U];
+            uint32_t c = src[n + 2U];
+            uint32_t d = src[n + 3U];
+
+            dst[n] = a;
+            dst[n + 1U] = b;
+            dst[n + 2U] = c;
+            dst[n + 3U] = d;
+        }
+    }
+
+    for (; n < words; n++)
+    {
+        dst[n * dst_step] = src[n * src_step];
+    }
+}
@@ -0,0 +1,159 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Header file for the board DDR retention engine. DRAM words that the
+ * PHY retraining on retention exit overwrites are listed as runs of
+ * (base, length, stride, mask). At init the runs are compacted into
+ * blocks of evenly spaced words, joining runs that continue one
+ * another and dropping words left out of the mask at build time. The
+ * blocks are copied to one buffer before the DRAM enters retention and
+ * back after it exits, in the order of the runs.
+ *
+ * @addtogroup BRD_SVC (BRD) Board Interface
+ *
+ * @{
+ */
+/*==========================================================================*/
+
+#ifndef SC_DDR_RET_H
+#define SC_DDR_RET_H
+
+/* Includes */
+
+#include "main/types.h"
+
+/* Defines */
+
+/*!
+ * Maximum number of blocks after compaction
+ */
+#ifndef DDR_RET_MAX_BLK
+    #define DDR_RET_MAX_BLK     8U
+#endif
+
+/*!
+ * Mask keeping every word of a run
+ */
+#define DDR_RET_MASK_ALL        0xFFFFFFFFU
+
+/* Types */
+
+/*!
+ * Run of DRAM words to retain. Word n is at \a base + n * \a stride
+ * and is kept if bit (n % 32) of \a mask is set. A stride of 0 means
+ * adjacent words.
+ */
+typedef struct
+{
+    uint32_t base;          /*!< Address of word 0 */
+    uint32_t len;           /*!< Number of words, kept or not */
+    uint32_t stride;        /*!< Bytes between words */
+    uint32_t mask;          /*!< Kept words, repeating every 32 */
+} ddr_ret_run_t;
+
+/*!
+ * Compacted block and its last copy times
+ */
+typedef struct
+{
+    uint32_t addr;          /*!< Address of the first word */
+    uint16_t words;         /*!< Words copied */
+    uint16_t stride;        /*!< Bytes between words */
+    uint64_t save_ns;       /*!< Time of the last save */
+    uint64_t restore_ns;    /*!< Time of the last restore */
+} ddr_ret_blk_t;
+
+/*!
+ * Engine statistics
+ */
+typedef struct
+{
+    uint32_t runs;          /*!< Runs given to ddr_ret_init() */
+    uint32_t blocks;        /*!< Blocks after compaction */
+    uint32_t words;         /*!< Words kept */
+    uint32_t skipped;       /*!< Words left out by masks */
+    uint32_t saves;         /*!< Saves done */
+    uint32_t restores;      /*!< Restores done */
+    uint32_t save_us;       /*!< Time of the last save */
+    uint32_t restore_us;    /*!< Time of the last restore */
+    ddr_ret_blk_t blk[DDR_RET_MAX_BLK];     /*!< Blocks in copy order */
+} ddr_ret_stats_t;
+
+/* Functions */
+
+/*!
+ * Compact the runs into blocks and assign their buffer space. Replaces
+ * any previous set of runs.
+ *
+ * @param[in]     run           runs in restore order
+ * @param[in]     num_run       number of runs
+ * @param[in]     buf           buffer for the kept words
+ * @param[in]     buf_words     size of \a buf in words
+ *
+ * @return Returns SC_ERR_UNAVAILABLE if the blocks or words do not fit,
+ *         SC_ERR_PARM if a run is not word aligned. Nothing is retained
+ *         on error.
+ */
+sc_err_t ddr_ret_init(const ddr_ret_run_t *run, uint32_t num_run,
+    uint32_t *buf, uint32_t buf_words);
+
+/*!
+ * Copy the blocks from DRAM to the buffer. Called before the DRAM
+ * enters retention.
+ */
+void ddr_ret_save(void);
+
+/*!
+ * Copy the blocks from the buffer back to DRAM. Called after the DRAM
+ * exits retention.
+ */
+void ddr_ret_restore(void);
+
+/*!
+ * Get the engine statistics.
+ *
+ * @param[out]    stats         statistics to fill in
+ */
+void ddr_ret_get_stats(ddr_ret_stats_t *stats);
+
+/**@}*/
+
+#endif /* SC_DDR_RET_H */
+
@@ -0,0 +1,435 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+/*==========================================================================*/
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Implementation of the board DVFS governor.
+ */
+/*==========================================================================*/
+
+/* Includes */
+
+#include "main/main.h"
+#include "main/board.h"
+#include "drivers/sysctr/fsl_sysctr.h"
+#include "all_svc.h"
+#include "board/dvfs.h"
+
+/* Local Functions */
+
+static dvfs_domain_t *dvfs_find(sc_rsrc_t rsrc);
+static uint8_t dvfs_need(const dvfs_domain_t *dom);
+static sc_err_t dvfs_check(sc_rm_pt_t caller_pt, sc_rsrc_t rsrc,
+    dvfs_domain_t **dom);
+static void dvfs_apply(dvfs_domain_t *dom, uint8_t target, uint64_t now);
+static void dvfs_tick(void);
+static void dvfs_run(void);
+
+/* Local Variables */
+
+static dvfs_domain_t *dvfs_dom = NULL;
+static uint32_t dvfs_num = 0U;
+static board_timer_t dvfs_timer;
+static board_work_t dvfs_work;
+static uint64_t dvfs_last;
+static uint32_t dvfs_pend_ms;
+
+/*--------------------------------------------------------------------------*/
+/* Register the governed domains                                            */
+/*--------------------------------------------------------------------------*/
+void dvfs_init(dvfs_domain_t *dom, uint32_t num)
+{
+    dvfs_dom = dom;
+    dvfs_num = num;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Enable or disable the governor for a resource                            */
+/*--------------------------------------------------------------------------*/
+sc_err_t dvfs_enable(sc_rm_pt_t caller_pt, sc_rsrc_t rsrc, sc_bool_t enb)
+{
+    dvfs_domain_t *dom;
+    sc_err_t err = dvfs_check(caller_pt, rsrc, &dom);
+
+    if ((err == SC_ERR_NONE) && (enb != dom->enabled))
+    {
+        uint32_t i;
+        sc_bool_t any = SC_FALSE;
+
+        if (enb != SC_FALSE)
+        {
+            sc_pm_clock_rate_t rate = 0U;
+
+            /* Start from the OPP at or below the current rate */
+            (void) pm_get_clock_rate(SC_PT, rsrc, dom->clk, &rate);
+            dom->cur = 0U;
+            for (i = 1U; i < dom->num_opp; i++)
+            {
+                if (dom->opp[i].freq <= rate)
+                {
+                    dom->cur = U8(i);
+                }
+            }
+            dom->load = 0U;
+            dom->low = 0U;
+            dom->last_ramp = 0ULL;
+        }
+        dom->enabled = enb;
+
+        /* Run the timer only while something is governed */
+        for (i = 0U; i < dvfs_num; i++)
+        {
+            if (dvfs_dom[i].enabled != SC_FALSE)
+            {
+                any = SC_TRUE;
+            }
+        }
+        if (any == SC_FALSE)
+        {
+            board_timer_stop(&dvfs_timer);
+        }
+        else if (dvfs_timer.active == SC_FALSE)
+        {
+            dvfs_last = board_get_counter64();
+            dvfs_pend_ms = 0U;
+            board_timer_start(&dvfs_timer, dvfs_tick, DVFS_PERIOD_MS,
+                DVFS_PERIOD_MS);
+        }
+        else
+        {
+            ; /* Intentional empty else */
+        }
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Set the performance floor of a resource                                  */
+/*--------------------------------------------------------------------------*/
+sc_err_t dvfs_set_floor(sc_rm_pt_t caller_pt, sc_rsrc_t rsrc,
+    uint32_t freq)
+{
+    dvfs_domain_t *dom;
+    sc_err_t err = dvfs_check(caller_pt, rsrc, &dom);
+
+    if (err == SC_ERR_NONE)
+    {
+        uint8_t floor = 0U;
+
+        while ((floor < dom->num_opp) && (dom->opp[floor].freq < freq))
+        {
+            floor++;
+        }
+
+        if (floor == dom->num_opp)
+        {
+            err = SC_ERR_PARM;
+        }
+        else
+        {
+            dom->floor = floor;
+        }
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Push a load hint for a resource                                          */
+/*--------------------------------------------------------------------------*/
+sc_err_t dvfs_hint(sc_rm_pt_t caller_pt, sc_rsrc_t rsrc, uint32_t load)
+{
+    dvfs_domain_t *dom;
+    sc_err_t err = dvfs_check(caller_pt, rsrc, &dom);
+
+    if ((err == SC_ERR_NONE) && (load > 100U))
+    {
+        err = SC_ERR_PARM;
+    }
+
+    if (err == SC_ERR_NONE)
+    {
+        dom->load = U8(load);
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get the statistics of a resource                                         */
+/*--------------------------------------------------------------------------*/
+sc_err_t dvfs_get_stats(sc_rsrc_t rsrc, dvfs_stats_t *stats)
+{
+    sc_err_t err = SC_ERR_NONE;
+    const dvfs_domain_t *dom = dvfs_find(rsrc);
+
+    if (dom == NULL)
+    {
+        err = SC_ERR_PARM;
+    }
+    else
+    {
+        ENTER_CS;
+        *stats = dom->stats;
+        EXIT_CS;
+        stats->num_opp = dom->num_opp;
+        stats->cur = dom->cur;
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Pick the next OPP of a domain                                            */
+/*--------------------------------------------------------------------------*/
+uint8_t dvfs_select(const dvfs_domain_t *dom, uint64_t now,
+    uint8_t *need)
+{
+    const dvfs_opp_t *opp = dom->opp;
+    uint8_t cur = dom->cur;
+    uint8_t top = dom->num_opp - 1U;
+    uint8_t target = cur;
+    uint8_t lowest = dvfs_need(dom);
+
+    *need = lowest;
+
+    if (lowest > cur)
+    {
+        /* Take all the headroom the new voltage gives */
+        target = lowest;
+        while ((target < top) && (opp[target + 1U].volt == opp[lowest].volt))
+        {
+            target++;
+        }
+    }
+    else if ((lowest < cur) && ((dom->low + 1U) >= DVFS_DOWN_HOLD))
+    {
+        target = lowest;
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    /* Rate limit voltage ramps, keep to the current voltage */
+    if ((opp[target].volt != opp[cur].volt) && ((now - dom->last_ramp)
+        < SYSCTR_USEC_TO_TICKS64(U64(DVFS_MIN_RAMP_MS) * 1000ULL)))
+    {
+        while ((target > cur) && (opp[target].volt != opp[cur].volt))
+        {
+            target--;
+        }
+        while ((target < cur) && (opp[target].volt != opp[cur].volt))
+        {
+            target++;
+        }
+    }
+
+    return target;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Find a governed domain                                                   */
+/*--------------------------------------------------------------------------*/
+static dvfs_domain_t *dvfs_find(sc_rsrc_t rsrc)
+{
+    dvfs_domain_t *dom = NULL;
+    uint32_t i;
+
+    for (i = 0U; i < dvfs_num; i++)
+    {
+        if (dvfs_dom[i].rsrc == rsrc)
+        {
+            dom = &dvfs_dom[i];
+            break;
+        }
+    }
+
+    return dom;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Lowest OPP serving the demand at the target load                         */
+/*--------------------------------------------------------------------------*/
+static uint8_t dvfs_need(const dvfs_domain_t *dom)
+{
+    const dvfs_opp_t *opp = dom->opp;
+    uint8_t top = dom->num_opp - 1U;
+    uint8_t lowest = 0U;
+    uint64_t demand = U64(opp[dom->cur].freq) * U64(dom->load);
+
+    while ((lowest < top) && ((U64(opp[lowest].freq) * DVFS_UP_PCT) < demand))
+    {
+        lowest++;
+    }
+    if (lowest < dom->floor)
+    {
+        lowest = dom->floor;
+    }
+
+    return lowest;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Find a domain the caller may control                                     */
+/*--------------------------------------------------------------------------*/
+static sc_err_t dvfs_check(sc_rm_pt_t caller_pt, sc_rsrc_t rsrc,
+    dvfs_domain_t **dom)
+{
+    sc_err_t err = SC_ERR_NONE;
+
+    *dom = dvfs_find(rsrc);
+    if (*dom == NULL)
+    {
+        err = SC_ERR_PARM;
+    }
+    else if (rm_is_resource_owned(caller_pt, rsrc) == SC_FALSE)
+    {
+        err = SC_ERR_NOACCESS;
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Move a domain to an OPP                                                  */
+/*--------------------------------------------------------------------------*/
+static void dvfs_apply(dvfs_domain_t *dom, uint8_t target, uint64_t now)
+{
+    sc_pm_clock_rate_t rate = dom->opp[target].freq;
+
+    /* The PM service sequences the voltage around the rate change */
+    if (pm_set_clock_rate(SC_PT, dom->rsrc, dom->clk, &rate) == SC_ERR_NONE)
+    {
+        dom->stats.transitions++;
+        if (dom->opp[target].volt != dom->opp[dom->cur].volt)
+        {
+            dom->stats.ramps++;
+            dom->last_ramp = now;
+        }
+        dom->cur = target;
+        dom->low = 0U;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Governor period, called from the board timer                             */
+/*--------------------------------------------------------------------------*/
+static void dvfs_tick(void)
+{
+    uint64_t now = board_get_counter64();
+    uint32_t ms = U32(SYSCTR_TICKS_TO_USEC64(now - dvfs_last) / 1000ULL);
+
+    /* Keep the sub-mS remainder for the next period */
+    dvfs_last += SYSCTR_USEC_TO_TICKS64(U64(ms) * 1000ULL);
+
+    /* The tick is interrupt context, decide and apply from the next RPC */
+    ENTER_CS;
+    dvfs_pend_ms += ms;
+    EXIT_CS;
+    board_rpc_work_post(&dvfs_work, dvfs_run);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Governor step for the periods since the last one, called in RPC context  */
+/*--------------------------------------------------------------------------*/
+static void dvfs_run(void)
+{
+    uint64_t now = board_get_counter64();
+    uint32_t ms;
+    uint32_t periods;
+    uint32_t i;
+
+    ENTER_CS;
+    ms = dvfs_pend_ms;
+    dvfs_pend_ms = 0U;
+    EXIT_CS;
+
+    /* Periods that passed before this RPC all count towards the hold */
+    periods = MAX(ms / DVFS_PERIOD_MS, 1U);
+
+    for (i = 0U; i < dvfs_num; i++)
+    {
+        dvfs_domain_t *dom = &dvfs_dom[i];
+        sc_pm_power_mode_t mode = SC_PM_PW_MODE_OFF;
+        uint8_t target;
+        uint8_t need;
+
+        if (dom->enabled == SC_FALSE)
+        {
+            continue;
+        }
+
+        /* Leave clocks of powered down domains alone */
+        (void) pm_get_resource_power_mode(SC_PT, dom->rsrc, &mode);
+        if (mode != SC_PM_PW_MODE_ON)
+        {
+            continue;
+        }
+
+        dom->stats.time_ms[dom->cur] += ms;
+
+        /* dvfs_select() counts one period, add the others */
+        if (dvfs_need(dom) < dom->cur)
+        {
+            dom->low = U8(MIN(U32(dom->low) + periods - 1U,
+                U32(UINT8_MAX) - 1U));
+        }
+
+        target = dvfs_select(dom, now, &need);
+        if (need < dom->cur)
+        {
+            dom->low++;
+        }
+        else
+        {
+            dom->low = 0U;
+        }
+
+        if (target != dom->cur)
+        {
+            dvfs_apply(dom, target, now);
+        }
+    }
+}
+
@@ -61,6 +61,7 @@
 #include "all_ss.h"
 #include "drivers/lpi2c/fsl_lpi2c.h"
 #include "drivers/pmic/fsl_pmic.h"
+#include "drivers/pmic/fsl_i2c_queue.h"
 #include "drivers/pmic/pf100/fsl_pf100.h"
 #include "drivers/pmic/pf8100/fsl_pf8100.h"
 #include "drivers/gpio/fsl_gpio.h"
@@ -72,7 +73,15 @@
 #include "pads.h"
 #include "drivers/pad/fsl_pad.h"
 #include "dcd/dcd_retention.h"
+#include "board/ddr_perf.h"
+#include "board/dvfs.h"
+#include "board/rpc_rec.h"
+#include "board/rm_index.h"
+#include "board/xrdc_shadow.h"
+#include "board/ddr_train.h"
+#include "board/ddr_ret.h"
 #include "eeprom.h"
+#include "board_ioctl.h"
 
 /* Local Defines */
 
@@ -122,11 +131,101 @@
     #define DEBUG_BAUD          115200U
 #endif
 
+/*! DCD checksum, generated into dcd_retention.h from the DCD .cfg */
+#ifndef BD_DCD_CHECKSUM
+    #define BD_DCD_CHECKSUM     0U
+#endif
+
+/*!
+ * DRAM checked after restoring cached training results. The check runs
+ * from board_init_ddr() before the ROM loads the boot images, so no
+ * image is in DRAM yet. Anything else kept over a warm reset (e.g. a
+ * crash log) is saved and written back by the check.
+ */
+#define BRD_DDR_TRAIN_CHECK     0x80000000U
+
+/*!
+ * @name PMIC thermal sense registers
+ * Read for the DDR training key before the PMIC is set up.
+ */
+/*@{*/
+#define BRD_PF100_INTSENSE0     0x07U
+#define BRD_PF100_THERM_MASK    0x3CU
+#define BRD_PF8100_THERMSENSE   0x09U
+#define BRD_PF8100_THERM_MASK   0x3FU
+/*@}*/
+
+/*!
+ * @name DDR retention runs
+ * A DCD .cfg may set BD_DDR_RET_REGIONn_STRIDE and BD_DDR_RET_REGIONn_MASK
+ * to leave out words of a region that retraining does not overwrite.
+ * The buffer still holds the whole regions so the SoC retention code
+ * can copy them if the runs cannot be set up. While the runs are in
+ * use the SoC code gets the regions copied in place, a no-op.
+ */
+/*@{*/
+#define BRD_DDR_RET_RUN(N)      {BD_DDR_RET_REGION##N##_ADDR, \
+                                BD_DDR_RET_REGION##N##_SIZE, \
+                                BD_DDR_RET_REGION##N##_STRIDE, \
+                                BD_DDR_RET_REGION##N##_MASK}
+#define BRD_DDR_RET_REGION(N)   {BD_DDR_RET_REGION##N##_ADDR, \
+                                BD_DDR_RET_REGION##N##_SIZE, \
+                                (uint32_t *) BD_DDR_RET_REGION##N##_ADDR}
+#define BRD_DDR_RET_SOC(N)      {BD_DDR_RET_REGION##N##_ADDR, \
+                                BD_DDR_RET_REGION##N##_SIZE, \
+                                &board_ddr_ret_buf[BRD_DDR_RET_OFS##N]}
+#define BRD_DDR_RET_OFS1        0U
+#define BRD_DDR_RET_OFS2        (BRD_DDR_RET_OFS1 + BD_DDR_RET_REGION1_SIZE)
+#define BRD_DDR_RET_OFS3        (BRD_DDR_RET_OFS2 + BD_DDR_RET_REGION2_SIZE)
+#define BRD_DDR_RET_OFS4        (BRD_DDR_RET_OFS3 + BD_DDR_RET_REGION3_SIZE)
+#define BRD_DDR_RET_OFS5        (BRD_DDR_RET_OFS4 + BD_DDR_RET_REGION4_SIZE)
+#define BRD_DDR_RET_OFS6        (BRD_DDR_RET_OFS5 + BD_DDR_RET_REGION5_SIZE)
+#ifndef BD_DDR_RET_REGION1_STRIDE
+    #define BD_DDR_RET_REGION1_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION1_MASK
+    #define BD_DDR_RET_REGION1_MASK     DDR_RET_MASK_ALL
+#endif
+#ifndef BD_DDR_RET_REGION2_STRIDE
+    #define BD_DDR_RET_REGION2_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION2_MASK
+    #define BD_DDR_RET_REGION2_MASK     DDR_RET_MASK_ALL
+#endif
+#ifndef BD_DDR_RET_REGION3_STRIDE
+    #define BD_DDR_RET_REGION3_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION3_MASK
+    #define BD_DDR_RET_REGION3_MASK     DDR_RET_MASK_ALL
+#endif
+#ifndef BD_DDR_RET_REGION4_STRIDE
+    #define BD_DDR_RET_REGION4_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION4_MASK
+    #define BD_DDR_RET_REGION4_MASK     DDR_RET_MASK_ALL
+#endif
+#ifndef BD_DDR_RET_REGION5_STRIDE
+    #define BD_DDR_RET_REGION5_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION5_MASK
+    #define BD_DDR_RET_REGION5_MASK     DDR_RET_MASK_ALL
+#endif
+#ifndef BD_DDR_RET_REGION6_STRIDE
+    #define BD_DDR_RET_REGION6_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION6_MASK
+    #define BD_DDR_RET_REGION6_MASK     DDR_RET_MASK_ALL
+#endif
+/*@}*/
+
 /* Local Types */
 
 /* Local Functions */
 
 static void pmic_init(void);
+#ifndef EMUL
+    static void pmic_i2c_init(void);
+#endif
 #ifndef EMUL
     static sc_err_t pmic_ignore_current_limit(uint8_t address,
         pmic_version_t ver);
@@ -134,6 +233,14 @@ static void pmic_init(void);
 #endif
 static void board_get_pmic_info(sc_sub_t ss,pmic_id_t *pmic_id,
     uint32_t *pmic_reg, uint8_t *num_regs);
+static void board_ramp_done(pmic_id_t id, uint32_t pmic_reg,
+    sc_err_t err);
+static void pmic_irq_work(void);
+static void board_ddr_train_get_key(ddr_train_key_t *key);
+
+/* Handlers (replace the weak defaults in the vector table) */
+
+void LPI2C0_IRQHandler(void);
 
 /* Local Variables */
 
@@ -142,6 +249,45 @@ static uint32_t pmic_card;
 static uint32_t temp_alarm0;
 static uint32_t temp_alarm1;
 static uint32_t temp_alarm2;
+static board_irq_defer_t pmic_irq;
+
+/*! Key of the DDR training cache for this boot, used by the DCD */
+static ddr_train_key_t board_ddr_train_key;
+
+/*!
+ * DVFS operating points, voltages as programmed by the SoC code.
+ */
+/*@{*/
+static const dvfs_opp_t dvfs_a53_opp[] =
+{
+    {600000000U, 1000000U}, {896000000U, 1000000U},
+    {1104000000U, 1100000U}, {1200000000U, 1100000U}
+};
+static const dvfs_opp_t dvfs_a72_opp[] =
+{
+    {600000000U, 1000000U}, {1056000000U, 1000000U},
+    {1296000000U, 1100000U}, {1596000000U, 1100000U}
+};
+static const dvfs_opp_t dvfs_gpu_opp[] =
+{
+    {372000000U, 1000000U}, {650000000U, 1000000U},
+    {800000000U, 1100000U}
+};
+/*@}*/
+
+/*! DVFS governed domains */
+static dvfs_domain_t dvfs_domain[] =
+{
+    {SC_R_A53, SC_PM_CLK_CPU, dvfs_a53_opp, U8(ARRAY_SIZE(dvfs_a53_opp))},
+    {SC_R_A72, SC_PM_CLK_CPU, dvfs_a72_opp, U8(ARRAY_SIZE(dvfs_a72_opp))},
+    {SC_R_GPU_0_PID0, SC_PM_CLK_PER, dvfs_gpu_opp,
+        U8(ARRAY_SIZE(dvfs_gpu_opp))},
+    {SC_R_GPU_1_PID0, SC_PM_CLK_PER, dvfs_gpu_opp,
+        U8(ARRAY_SIZE(dvfs_gpu_opp))}
+};
+
+/*! Boot partition, its parents may change system wide settings */
+static sc_rm_pt_t board_pt_boot = SC_PT;
 
 /*!
  * This constant contains info to map resources to the board.
@@ -210,6 +356,12 @@ void board_init(boot_phase_t phase)
 
     ss_print(3, "board_init(%d)\n", phase);
 
+    /* No HW access (SYSCTR) in the API phase */
+    if (phase != BOOT_PHASE_API_INIT)
+    {
+        board_boot_mark(BOARD_BOOT_INIT, U32(phase));
+    }
+
     if (phase == BOOT_PHASE_HW_INIT)
     {
         pad_force_mux(SC_P_SCU_GPIO0_02, 0U, SC_PAD_CONFIG_NORMAL,
@@ -223,7 +375,7 @@ void board_init(boot_phase_t phase)
         /* SCU_LED on */
         FGPIO_PinInit(FGPIOA, 2U, &config);
 
-        SystemTimeDelay(2U);
+        BOARD_DELAY(2U);
     }
     else if (phase == BOOT_PHASE_FINAL_INIT)
     {
@@ -232,6 +384,9 @@ void board_init(boot_phase_t phase)
 
         /* Init PMIC if not already done */
         pmic_init();
+
+        /* Register DVFS domains, governed once enabled by the owner */
+        dvfs_init(dvfs_domain, U32(ARRAY_SIZE(dvfs_domain)));
     }
     else if (phase == BOOT_PHASE_TEST_INIT)
     {
@@ -410,54 +565,90 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
         /* Storage for DRC PHY registers */
         static ddr_phy board_ddr_ret_drc_phy_inst[BD_DDR_RET_NUM_DRC];
         
-        /* Storage for DDR regions */
-        static uint32_t board_ddr_ret_buf1[BD_DDR_RET_REGION1_SIZE];
+        /* Storage for the DDR regions */
+        static uint32_t board_ddr_ret_buf[BD_DDR_RET_WORDS];
+        
+        /* DDR region runs, restored in this order */
+        static const ddr_ret_run_t board_ddr_ret_run[BD_DDR_RET_NUM_REGION] = 
+        {
+            BRD_DDR_RET_RUN(1),
         #ifdef BD_DDR_RET_REGION2_SIZE
-        static uint32_t board_ddr_ret_buf2[BD_DDR_RET_REGION2_SIZE];
+            BRD_DDR_RET_RUN(2),
         #endif
         #ifdef BD_DDR_RET_REGION3_SIZE
-        static uint32_t board_ddr_ret_buf3[BD_DDR_RET_REGION3_SIZE];
+            BRD_DDR_RET_RUN(3),
         #endif
         #ifdef BD_DDR_RET_REGION4_SIZE
-        static uint32_t board_ddr_ret_buf4[BD_DDR_RET_REGION4_SIZE];
+            BRD_DDR_RET_RUN(4),
         #endif
         #ifdef BD_DDR_RET_REGION5_SIZE
-        static uint32_t board_ddr_ret_buf5[BD_DDR_RET_REGION5_SIZE];
+            BRD_DDR_RET_RUN(5),
         #endif
         #ifdef BD_DDR_RET_REGION6_SIZE
-        static uint32_t board_ddr_ret_buf6[BD_DDR_RET_REGION6_SIZE];
+            BRD_DDR_RET_RUN(6)
         #endif
-        
-        /* DDR region descriptors */
+        };
+
+        /* DDR region descriptors copied in place, backstop for the runs */
         static const soc_ddr_ret_region_t board_ddr_ret_region[BD_DDR_RET_NUM_REGION] = 
         {
-            { BD_DDR_RET_REGION1_ADDR, BD_DDR_RET_REGION1_SIZE, board_ddr_ret_buf1 },
+            BRD_DDR_RET_REGION(1),
         #ifdef BD_DDR_RET_REGION2_SIZE
-            { BD_DDR_RET_REGION2_ADDR, BD_DDR_RET_REGION2_SIZE, board_ddr_ret_buf2 },
+            BRD_DDR_RET_REGION(2),
         #endif
         #ifdef BD_DDR_RET_REGION3_SIZE
-            { BD_DDR_RET_REGION3_ADDR, BD_DDR_RET_REGION3_SIZE, board_ddr_ret_buf3 },
+            BRD_DDR_RET_REGION(3),
         #endif
         #ifdef BD_DDR_RET_REGION4_SIZE
-            { BD_DDR_RET_REGION4_ADDR, BD_DDR_RET_REGION4_SIZE, board_ddr_ret_buf4 },
+            BRD_DDR_RET_REGION(4),
         #endif
         #ifdef BD_DDR_RET_REGION5_SIZE
-            { BD_DDR_RET_REGION5_ADDR, BD_DDR_RET_REGION5_SIZE, board_ddr_ret_buf5 },
+            BRD_DDR_RET_REGION(5),
         #endif
         #ifdef BD_DDR_RET_REGION6_SIZE
-            { BD_DDR_RET_REGION6_ADDR, BD_DDR_RET_REGION6_SIZE, board_ddr_ret_buf6 }
+            BRD_DDR_RET_REGION(6)
         #endif
         };
 
-        /* DDR retention descriptor passed to SCFW */
+        /* DDR region descriptors, used if the runs are rejected */
+        static const soc_ddr_ret_region_t board_ddr_ret_region_soc[BD_DDR_RET_NUM_REGION] = 
+        {
+            BRD_DDR_RET_SOC(1),
+        #ifdef BD_DDR_RET_REGION2_SIZE
+            BRD_DDR_RET_SOC(2),
+        #endif
+        #ifdef BD_DDR_RET_REGION3_SIZE
+            BRD_DDR_RET_SOC(3),
+        #endif
+        #ifdef BD_DDR_RET_REGION4_SIZE
+            BRD_DDR_RET_SOC(4),
+        #endif
+        #ifdef BD_DDR_RET_REGION5_SIZE
+            BRD_DDR_RET_SOC(5),
+        #endif
+        #ifdef BD_DDR_RET_REGION6_SIZE
+            BRD_DDR_RET_SOC(6)
+        #endif
+        };
+
+        /* DDR retention descriptor passed to SCFW, the regions are
+           copied by the board retention engine */
         static soc_ddr_ret_info_t board_ddr_ret_info = 
         { 
           BD_DDR_RET_NUM_DRC, board_ddr_ret_drc_inst, board_ddr_ret_drc_phy_inst, 
           BD_DDR_RET_NUM_REGION, board_ddr_ret_region
         };
+
+        /* DDR retention descriptor with the regions copied by SCFW */
+        static soc_ddr_ret_info_t board_ddr_ret_info_soc = 
+        { 
+          BD_DDR_RET_NUM_DRC, board_ddr_ret_drc_inst, board_ddr_ret_drc_phy_inst, 
+          BD_DDR_RET_NUM_REGION, board_ddr_ret_region_soc
+        };
     #endif
 
     board_print(3, "board_init_ddr(%d)\n", early);
+    board_boot_mark(BOARD_BOOT_DDR, U32(early));
 
     #ifdef SKIP_DDR
         return SC_ERR_UNAVAILABLE;
@@ -469,11 +660,23 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
 
         if ((err == SC_ERR_NONE) && (ddr_initialized == SC_FALSE))
         {
+            board_ddr_train_get_key(&board_ddr_train_key);
+
             board_print(1, "SCFW: ");
             err = board_ddr_config(SC_FALSE, BOARD_DDR_COLD_INIT);
             #ifdef LP4_MANUAL_DERATE_WORKAROUND
                 ddrc_lpddr4_derate_init(BD_DDR_RET_NUM_DRC);
             #endif
+
+            /* Restored training results must pass a DRAM check, else
+               drop them and reset to train */
+            if ((err == SC_ERR_NONE)
+                && (ddr_train_verify(BRD_DDR_TRAIN_CHECK) != SC_ERR_NONE))
+            {
+                error_print("DDR training cache check failed\n");
+                (void) board_reset(SC_PM_RESET_TYPE_COLD,
+                    SC_PM_RESET_REASON_SCFW_FAULT, SC_PT);
+            }
         }
 
         #ifdef DEBUG_BOARD
@@ -498,7 +701,16 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
         if (err == SC_ERR_NONE)
         {
             #ifdef BD_DDR_RET
-                soc_ddr_config_retention(&board_ddr_ret_info);
+                if (ddr_ret_init(board_ddr_ret_run, BD_DDR_RET_NUM_REGION,
+                    board_ddr_ret_buf, BD_DDR_RET_WORDS) != SC_ERR_NONE)
+                {
+                    error_print("DDR retention runs rejected\n");
+                    soc_ddr_config_retention(&board_ddr_ret_info_soc);
+                }
+                else
+                {
+                    soc_ddr_config_retention(&board_ddr_ret_info);
+                }
             #endif
 
             #ifdef BD_LPDDR4_INC_DQS2DQ
@@ -512,6 +724,8 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
             board_ddr_derate_periodic_enable(SC_TRUE);
         #endif
 
+        board_boot_mark(BOARD_BOOT_DDR_DONE, U32(err));
+
         return err;
     #endif
 }
@@ -542,13 +756,16 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
             board_ddr_derate_periodic_enable(SC_FALSE);
     #endif
             board_ddr_periodic_enable(SC_FALSE);
+            ddr_perf_pause(SC_TRUE);
     #ifdef BD_DDR_RET
+            ddr_ret_save();
             soc_ddr_enter_retention();
     #endif
             break;
         case BOARD_DDR_SR_DRC_OFF_EXIT:
     #ifdef BD_DDR_RET
             soc_ddr_exit_retention();
+            ddr_ret_restore();
     #endif
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
             ddrc_lpddr4_derate_init(BD_DDR_RET_NUM_DRC);
@@ -558,12 +775,14 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
             soc_ddr_dqs2dq_init();
     #endif
             board_ddr_periodic_enable(SC_TRUE);
+            ddr_perf_pause(SC_FALSE);
             break;
         case BOARD_DDR_SR_DRC_ON_ENTER:
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
             board_ddr_derate_periodic_enable(SC_FALSE);
     #endif
             board_ddr_periodic_enable(SC_FALSE);
+            ddr_perf_pause(SC_TRUE);
             soc_self_refresh_power_down_clk_disable_entry();
             break;
         case BOARD_DDR_SR_DRC_ON_EXIT:
@@ -576,12 +795,14 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
             soc_ddr_dqs2dq_periodic();
     #endif
             board_ddr_periodic_enable(SC_TRUE);
+            ddr_perf_pause(SC_FALSE);
             break;
         case BOARD_DDR_PERIODIC_HALT:
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
             board_ddr_derate_periodic_enable(SC_FALSE);
     #endif
             board_ddr_periodic_enable(SC_FALSE);
+            ddr_perf_pause(SC_TRUE);
             break;
         case BOARD_DDR_PERIODIC_RESTART:
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
@@ -592,6 +813,7 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
             soc_ddr_dqs2dq_periodic();
     #endif
             board_ddr_periodic_enable(SC_TRUE);
+            ddr_perf_pause(SC_FALSE);
             break;
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
         case BOARD_DDR_DERATE_PERIODIC:
@@ -610,6 +832,63 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
     return err;
 }
 
+/*--------------------------------------------------------------------------*/
+/* Build the DDR training cache key for this boot                           */
+/*--------------------------------------------------------------------------*/
+static void board_ddr_train_get_key(ddr_train_key_t *key)
+{
+    uint32_t rate = 0U;
+    #ifndef EMUL
+        uint8_t sense = 0U;
+    #endif
+
+    /* DRC clock rate */
+    if (rm_is_resource_avail(SC_R_DRC_0))
+    {
+        (void) pm_get_clock_rate(SC_PT, SC_R_DRC_0, SC_PM_CLK_MISC0,
+            &rate);
+    }
+    else if (rm_is_resource_avail(SC_R_DRC_1))
+    {
+        (void) pm_get_clock_rate(SC_PT, SC_R_DRC_1, SC_PM_CLK_MISC0,
+            &rate);
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    key->dcd = BD_DCD_CHECKSUM;
+    key->rate = rate;
+    key->board = OTP_UNIQUE_ID_L ^ OTP_UNIQUE_ID_H;
+
+    /*
+     * Temperature band, the thermal thresholds PMIC 0 reports crossed.
+     * Only the I2C is brought up, the PMIC is set up after DDR init.
+     */
+    key->band = 0U;
+    #ifndef EMUL
+        pmic_i2c_init();
+        if (pmic_get_device_id(PMIC_0_ADDR) == PF100_DEV_ID)
+        {
+            if (i2c_read(PMIC_0_ADDR, BRD_PF100_INTSENSE0, &sense, 1U)
+                == I32(kStatus_Success))
+            {
+                key->band = U32(sense) & BRD_PF100_THERM_MASK;
+            }
+        }
+        else if (I2C_READ(PMIC_0_ADDR, BRD_PF8100_THERMSENSE, &sense, 1U)
+            == I32(kStatus_Success))
+        {
+            key->band = U32(sense) & BRD_PF8100_THERM_MASK;
+        }
+        else
+        {
+            ; /* Intentional empty else */
+        }
+    #endif
+}
+
 /*--------------------------------------------------------------------------*/
 /* Configure the system (inc. additional resource partitions)               */
 /*--------------------------------------------------------------------------*/
@@ -632,7 +911,10 @@ sc_err_t board_system_config(sc_bool_t early, sc_rm_pt_t pt_boot)
     (void) boot_get_data(NULL, NULL, NULL, NULL, NULL, NULL, &alt_config,
         NULL, NULL, &no_ap);
 
+    board_pt_boot = pt_boot;
+
     board_print(3, "board_system_config(%d, %d)\n", early, alt_config);
+    board_boot_mark(BOARD_BOOT_CONFIG, U32(alt_config));
 
     /* Configure initial resource allocation (note additional allocation
        and assignments can be made by the SCFW clients at run-time */
@@ -648,6 +930,9 @@ sc_err_t board_system_config(sc_bool_t early, sc_rm_pt_t pt_boot)
             rm_dump(pt_boot);
         #endif
 
+        /* Hold XRDC writes until the partitions are built */
+        xrdc_shadow_begin();
+
         /* Mark all resources as not movable */
         BRD_ERR(rm_set_resource_movable(pt_boot, SC_R_ALL, SC_R_ALL,
             SC_FALSE));
@@ -796,6 +1081,10 @@ sc_err_t board_system_config(sc_bool_t early, sc_rm_pt_t pt_boot)
         BRD_ERR(rm_assign_resource(pt_m4_1, pt_sh, SC_R_M4_1_PID3));
         BRD_ERR(rm_assign_resource(pt_m4_1, pt_sh, SC_R_M4_1_PID4));
 
+        /* Write the held XRDC updates */
+        xrdc_shadow_commit();
+        board_boot_mark(BOARD_BOOT_PART, 0U);
+
         #ifdef BOARD_RM_DUMP
             rm_dump(pt_boot);
         #endif
@@ -815,6 +1104,8 @@ sc_bool_t board_early_cpu(sc_rsrc_t cpu)
 {
     sc_bool_t rtn = SC_FALSE;
 
+    board_boot_mark(BOARD_BOOT_CPU, U32(cpu));
+
     if ((cpu == SC_R_M4_0_PID0) || (cpu == SC_R_M4_1_PID0))
     {
         rtn = SC_TRUE;
@@ -863,7 +1154,7 @@ void board_set_power_mode(sc_sub_t ss, uint8_t pd,
                     mode);
                 idx++;
             }
-            SystemTimeDelay(PMIC_MAX_RAMP);
+            BOARD_DELAY(PMIC_MAX_RAMP);
         }
         else
         {
@@ -920,12 +1211,35 @@ sc_err_t board_set_voltage(sc_sub_t ss, uint32_t new_volt, uint32_t old_volt)
                 mode);
             idx++;
         }
+        idx = 0U;
         if ((old_volt != 0U) && (new_volt > old_volt))
         {
-            /* PMIC_MAX_RAMP_RATE is in nano Volts. */
-            uint32_t ramp_time = ((new_volt - old_volt) * 1000U)
-                / PMIC_MAX_RAMP_RATE;
-            SystemTimeDelay(ramp_time + 1U);
+            /* Rising, wait for power good before the load is raised */
+            uint32_t settle = pmic_ramp_time(old_volt, new_volt,
+                PMIC_MAX_RAMP_RATE);
+
+            if (pmic_ramp_wait(pmic_id, pmic_reg, num_regs, settle,
+                settle + PMIC_MAX_RAMP) != SC_ERR_NONE)
+            {
+                board_print(1, "%s ramp timeout\n", snames[ss]);
+            }
+        }
+        else if (new_volt < old_volt)
+        {
+            /* Falling, the load is already lowered so do not block */
+            uint32_t settle = pmic_ramp_time(old_volt, new_volt,
+                PMIC_MAX_RAMP_RATE);
+
+            while (idx < num_regs)
+            {
+                (void) pmic_ramp_start(pmic_id[idx], pmic_reg[idx], settle,
+                    settle + PMIC_MAX_RAMP, board_ramp_done);
+                idx++;
+            }
+        }
+        else
+        {
+            ; /* Intentional empty else */
         }
     }
 
@@ -1465,36 +1779,42 @@ sc_err_t board_get_control(sc_rsrc_t resource, sc_rm_idx_t idx,
 /*--------------------------------------------------------------------------*/
 void PMIC_IRQHandler(void)
 {
+    /* Mask INTB and defer the I2C servicing to the board worker */
+    board_irq_defer_raise(&pmic_irq);
+}
+
+/*--------------------------------------------------------------------------*/
+/* PMIC interrupt bottom half                                               */
+/*--------------------------------------------------------------------------*/
+static void pmic_irq_work(void)
+{
+    uint32_t alarms = 0U;
+
     /* Handle IRQ */
     switch (pmic_card)
     {
         case PF100_TRIPLE :
             if (PMIC_IRQ_SERVICE(PMIC_2_ADDR) != SC_FALSE)
             {
-                ss_irq_trigger(SC_IRQ_GROUP_TEMP,
-                    SC_IRQ_TEMP_PMIC2_HIGH, SC_PT_ALL);
+                alarms |= SC_IRQ_TEMP_PMIC2_HIGH;
             }
             if (PMIC_IRQ_SERVICE(PMIC_1_ADDR) != SC_FALSE)
             {
-                ss_irq_trigger(SC_IRQ_GROUP_TEMP,
-                    SC_IRQ_TEMP_PMIC1_HIGH, SC_PT_ALL);
+                alarms |= SC_IRQ_TEMP_PMIC1_HIGH;
             }
             if (PMIC_IRQ_SERVICE(PMIC_0_ADDR) != SC_FALSE)
             {
-                ss_irq_trigger(SC_IRQ_GROUP_TEMP,
-                    SC_IRQ_TEMP_PMIC0_HIGH, SC_PT_ALL);
+                alarms |= SC_IRQ_TEMP_PMIC0_HIGH;
             }
             break;
         case PF8100_DUAL :
             if (PMIC_IRQ_SERVICE(PMIC_1_ADDR) != SC_FALSE)
             {
-                ss_irq_trigger(SC_IRQ_GROUP_TEMP,
-                    SC_IRQ_TEMP_PMIC1_HIGH, SC_PT_ALL);
+                alarms |= SC_IRQ_TEMP_PMIC1_HIGH;
             }
             if (PMIC_IRQ_SERVICE(PMIC_0_ADDR) != SC_FALSE)
             {
-                ss_irq_trigger(SC_IRQ_GROUP_TEMP,
-                    SC_IRQ_TEMP_PMIC0_HIGH, SC_PT_ALL);
+                alarms |= SC_IRQ_TEMP_PMIC0_HIGH;
             }
             break;
         default :
@@ -1502,7 +1822,13 @@ void PMIC_IRQHandler(void)
             break;
     }
 
-    NVIC_ClearPendingIRQ(PMIC_INT_IRQn);
+    /* One notification for all PMICs serviced */
+    if (alarms != 0U)
+    {
+        board_notify(SC_IRQ_GROUP_TEMP, alarms, SC_PT_ALL);
+    }
+
+    board_irq_defer_done(&pmic_irq);
 }
 
 /*--------------------------------------------------------------------------*/
@@ -1512,11 +1838,61 @@ void SNVS_Button_IRQHandler(void)
 {
     SNVS_ClearButtonIRQ();
 
-    ss_irq_trigger(SC_IRQ_GROUP_WAKE, SC_IRQ_BUTTON, SC_PT_ALL);
+    board_notify(SC_IRQ_GROUP_WAKE, SC_IRQ_BUTTON, SC_PT_ALL);
+}
+
+/*--------------------------------------------------------------------------*/
+/* PMIC LPI2C Handler                                                       */
+/*--------------------------------------------------------------------------*/
+void LPI2C0_IRQHandler(void)
+{
+    i2c_queue_irq_handler();
 }
 
 /*==========================================================================*/
 
+#ifndef EMUL
+/*--------------------------------------------------------------------------*/
+/* Init the I2C to the PMIC                                                 */
+/*--------------------------------------------------------------------------*/
+static void pmic_i2c_init(void)
+{
+    static sc_bool_t i2c_ready = SC_FALSE;
+    static lpi2c_master_config_t lpi2c_masterConfig;
+    sc_pm_clock_rate_t rate = SC_24MHZ;
+
+    if (i2c_ready == SC_FALSE)
+    {
+        i2c_ready = SC_TRUE;
+
+        /* Power up the I2C and configure clocks */
+        pm_force_resource_power_mode_v(SC_R_SC_I2C,
+            SC_PM_PW_MODE_ON);
+        (void) pm_set_clock_rate(SC_PT, SC_R_SC_I2C,
+            SC_PM_CLK_PER, &rate);
+        (void) pm_force_clock_enable(SC_R_SC_I2C, SC_PM_CLK_PER,
+            SC_TRUE);
+
+        /* Initialize the pads used to communicate with the PMIC */
+        pad_force_mux(SC_P_PMIC_I2C_SDA, 0,
+            SC_PAD_CONFIG_OD_IN, SC_PAD_ISO_OFF);
+        (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_I2C_SDA,
+            SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
+        pad_force_mux(SC_P_PMIC_I2C_SCL, 0,
+            SC_PAD_CONFIG_OD_IN, SC_PAD_ISO_OFF);
+        (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_I2C_SCL,
+            SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
+
+        /* Initialize the I2C used to communicate with the PMIC */
+        LPI2C_MasterGetDefaultConfig(&lpi2c_masterConfig);
+        LPI2C_MasterInit(LPI2C_PMIC, &lpi2c_masterConfig, SC_24MHZ);
+
+        /* Delay to allow I2C to settle */
+        BOARD_DELAY(2U);
+    }
+}
+#endif
+
 /*--------------------------------------------------------------------------*/
 /* Init the PMIC interface                                                  */
 /*--------------------------------------------------------------------------*/
@@ -1524,8 +1900,6 @@ static void pmic_init(void)
 {
     #ifndef EMUL
         static sc_bool_t pmic_checked = SC_FALSE;
-        static lpi2c_master_config_t lpi2c_masterConfig;
-        sc_pm_clock_rate_t rate = SC_24MHZ;
 
         /* See if we already checked for the PMIC */
         if (pmic_checked == SC_FALSE)
@@ -1536,24 +1910,10 @@ static void pmic_init(void)
 
             /* Initialize the PMIC */
             board_print(3, "Start PMIC init\n");
+            board_boot_mark(BOARD_BOOT_PMIC, 0U);
 
-            /* Power up the I2C and configure clocks */
-            pm_force_resource_power_mode_v(SC_R_SC_I2C,
-                SC_PM_PW_MODE_ON);
-            (void) pm_set_clock_rate(SC_PT, SC_R_SC_I2C,
-                SC_PM_CLK_PER, &rate);
-            (void) pm_force_clock_enable(SC_R_SC_I2C, SC_PM_CLK_PER,
-                SC_TRUE);
-
-            /* Initialize the pads used to communicate with the PMIC */
-            pad_force_mux(SC_P_PMIC_I2C_SDA, 0,
-                SC_PAD_CONFIG_OD_IN, SC_PAD_ISO_OFF);
-            (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_I2C_SDA,
-                SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
-            pad_force_mux(SC_P_PMIC_I2C_SCL, 0,
-                SC_PAD_CONFIG_OD_IN, SC_PAD_ISO_OFF);
-            (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_I2C_SCL,
-                SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
+            /* Bring up the I2C to the PMIC */
+            pmic_i2c_init();
 
             /* Initialize the PMIC interrupt pad */
             pad_force_mux(SC_P_PMIC_INT_B, 0,
@@ -1561,19 +1921,17 @@ static void pmic_init(void)
             (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_INT_B,
                 SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
 
-            /* Initialize the I2C used to communicate with the PMIC */
-            LPI2C_MasterGetDefaultConfig(&lpi2c_masterConfig);
-            LPI2C_MasterInit(LPI2C_PMIC, &lpi2c_masterConfig, SC_24MHZ);
-
-            /* Delay to allow I2C to settle */
-            SystemTimeDelay(2U);
+            /* Run PMIC/EEPROM transfers from the LPI2C IRQ */
+            i2c_queue_init();
 
             /* Probe for PMIC 0 */
             if (pmic_get_device_id(PMIC_0_ADDR) == PF100_DEV_ID)
             { /* probe for pmic at 0x8 */
                 board_print(2, "Found Triple PF100 PMIC Card \n");
                 pmic_card = PF100_TRIPLE;
-                PMIC_TYPE = PF100;
+                (void) pmic_register(PMIC_0_ADDR, PF100);
+                (void) pmic_register(PMIC_1_ADDR, PF100);
+                (void) pmic_register(PMIC_2_ADDR, PF100);
                 /* Probe for PMIC 1 */
                 pmic_ver = GET_PMIC_VERSION(PMIC_0_ADDR);
 
@@ -1590,7 +1948,8 @@ static void pmic_init(void)
             else if ((pmic_get_device_id(PMIC_1_ADDR) & FAM_ID_MASK) == PF8X00_FAM_ID)
             {
                 pmic_card = PF8100_DUAL;
-                PMIC_TYPE = PF8100;
+                (void) pmic_register(PMIC_0_ADDR, PF8100);
+                (void) pmic_register(PMIC_1_ADDR, PF8100);
                 pmic_ver = GET_PMIC_VERSION(PMIC_0_ADDR);
                 board_print(2, "Found Dual PF8100 PMIC Card Rev:0x%x\n",pmic_ver.si_rev);
                 temp_alarm0 = SET_PMIC_TEMP_ALARM(PMIC_0_ADDR, PMIC_TEMP_MAX);
@@ -1672,9 +2031,11 @@ static void pmic_init(void)
                 #endif
             }
 
-            /* Enable PMIC IRQ at NVIC level */
-            NVIC_EnableIRQ(PMIC_INT_IRQn);
+            /* Enable PMIC IRQ at NVIC level, serviced by the worker */
+            board_irq_defer_init(&pmic_irq, PMIC_INT_IRQn, pmic_irq_work);
 
+            board_boot_mark(BOARD_BOOT_PMIC_DONE,
+                U32(pmic_ver.device_id));
             board_print(3, "Finished  PMIC init\n\n");
         }
     #endif
@@ -1689,6 +2050,7 @@ static sc_err_t pmic_ignore_current_limit(uint8_t address, pmic_version_t ver)
     sc_err_t err = SC_ERR_NONE;
     uint8_t idx;
     uint8_t val = 0U;
+    uint8_t old;
     static const pf8100_vregs_t switchers[11] =
     {
         PF8100_SW1,
@@ -1704,6 +2066,10 @@ static sc_err_t pmic_ignore_current_limit(uint8_t address, pmic_version_t ver)
         PF8100_LDO4
     };
 
+    /* Pull the regulator block into the shadow in a few bursts */
+    (void) pf8100_pmic_prefetch(address, PF8100_SW1,
+        U8(PF8100_LDO4 - PF8100_SW1 + 1U));
+
     for (idx = 0U; idx < 11U; idx++)
     {
         /* Read the config register first */
@@ -1712,6 +2078,7 @@ static sc_err_t pmic_ignore_current_limit(uint8_t address, pmic_version_t ver)
 
         if (err == SC_ERR_NONE)
         {
+            old = val;
     		if (ver.si_rev == PF8100_A0_REV)
     		{	/* only bypass current limit on A0 silicon */
     			val |= 0x20U; /* set xx_ILIM_BYPASS */
@@ -1731,8 +2098,11 @@ static sc_err_t pmic_ignore_current_limit(uint8_t address, pmic_version_t ver)
                 val |= 0xC0U;
             }
 
-            err = PMIC_REGISTER_ACCESS(address, switchers[idx], SC_TRUE,
-                &val);
+            if (val != old)
+            {
+                err = PMIC_REGISTER_ACCESS(address, switchers[idx], SC_TRUE,
+                    &val);
+            }
         }
 
         if (err != SC_ERR_NONE)
@@ -1797,6 +2167,17 @@ static sc_err_t pmic_match_otp(uint8_t address, pmic_version_t ver)
 }
 #endif
 
+/*--------------------------------------------------------------------------*/
+/* Completion of a non-blocking voltage ramp                                */
+/*--------------------------------------------------------------------------*/
+static void board_ramp_done(pmic_id_t id, uint32_t pmic_reg, sc_err_t err)
+{
+    if (err != SC_ERR_NONE)
+    {
+        board_print(1, "PMIC 0x%x reg 0x%x ramp timeout\n", id, pmic_reg);
+    }
+}
+
 /*--------------------------------------------------------------------------*/
 /* Get the pmic ids and switchers connected to SS.                          */
 /*--------------------------------------------------------------------------*/
@@ -1906,9 +2287,150 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
     always_print("IOCTL Function called! Cmd is %d, Buffer Addr is 0x%08x, Size is 0x%08x\n",
 			*command, *p1, *p2);
 
-    /* For test_misc */
     switch (*command) {
 
+	/* Batched RPC calls: p1 = message array, p2 = number of calls */
+	case SCFW_RPC_BATCH:
+		err = board_rpc_batch(caller_pt, mu, (sc_rpc_msg_t *)*p1, p2);
+		break;
+
+	/* DDR bandwidth: p1 = ddr_perf_stats_t buffer, p2 = DRC index */
+	case SCFW_DDR_PERF_GET:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(ddr_perf_stats_t));
+		if (err == SC_ERR_NONE)
+			err = ddr_perf_get_stats(*p2, (ddr_perf_stats_t *)buff);
+		break;
+
+	/* DDR bandwidth sampling: p1 = enable flag */
+	case SCFW_DDR_PERF_ENABLE:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			ddr_perf_enable((*p1 != 0U) ? SC_TRUE : SC_FALSE);
+		break;
+
+	/* DVFS governor: p1 = resource, p2 = enable flag */
+	case SCFW_DVFS_ENABLE:
+		err = dvfs_enable(caller_pt, (sc_rsrc_t)*p1,
+			(*p2 != 0U) ? SC_TRUE : SC_FALSE);
+		break;
+
+	/* DVFS performance floor: p1 = resource, p2 = rate in Hz */
+	case SCFW_DVFS_FLOOR:
+		err = dvfs_set_floor(caller_pt, (sc_rsrc_t)*p1, *p2);
+		break;
+
+	/* DVFS load hint: p1 = resource, p2 = load in % */
+	case SCFW_DVFS_HINT:
+		err = dvfs_hint(caller_pt, (sc_rsrc_t)*p1, *p2);
+		break;
+
+	/* DVFS statistics: p1 = dvfs_stats_t buffer, p2 = resource */
+	case SCFW_DVFS_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(dvfs_stats_t));
+		if (err == SC_ERR_NONE)
+			err = dvfs_get_stats((sc_rsrc_t)*p2, (dvfs_stats_t *)buff);
+		break;
+
+	case SCFW_PMIC_RAMP_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(pmic_ramp_stats_t));
+		if (err == SC_ERR_NONE)
+			pmic_ramp_get_stats((pmic_ramp_stats_t *)buff);
+		break;
+
+	case SCFW_PMIC_IRQ_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(board_irq_stats_t));
+		if (err == SC_ERR_NONE)
+			*(board_irq_stats_t *)buff = pmic_irq.stats;
+		break;
+
+	/* Partition notification coalescing: p1 = window in mS */
+	case SCFW_NOTIFY_CONFIG:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			board_notify_config(*p1);
+		break;
+
+	/* p1 = mask of BIT(group) delivered immediately to the caller */
+	case SCFW_NOTIFY_IMMEDIATE:
+		board_notify_immediate(caller_pt, *p1);
+		err = SC_ERR_NONE;
+		break;
+
+	case SCFW_NOTIFY_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(board_notify_stats_t));
+		if (err == SC_ERR_NONE)
+			board_notify_get_stats((board_notify_stats_t *)buff);
+		break;
+
+	/* RPC flight recorder dump: p1 = buffer, p2 = size, returns used */
+	case SCFW_RPC_REC_DUMP:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			err = board_check_caller_buf(caller_pt, buff, size);
+		if (err == SC_ERR_NONE)
+			err = rpc_rec_dump(caller_pt, buff, p2);
+		break;
+
+	case SCFW_RPC_REC_ENABLE:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			rpc_rec_enable((*p1 != 0U) ? SC_TRUE : SC_FALSE);
+		break;
+
+	/* Resources and pads owned by the caller as bitsets */
+	case SCFW_RM_INDEX:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(rm_index_t));
+		if (err == SC_ERR_NONE)
+			rm_index_build(caller_pt, (rm_index_t *)buff);
+		break;
+
+	case SCFW_XRDC_SHADOW_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(xrdc_shadow_stats_t));
+		if (err == SC_ERR_NONE)
+			xrdc_shadow_get_stats((xrdc_shadow_stats_t *)buff);
+		break;
+
+	/* Boot ledger: p1 = buffer, p2 = size, returns bytes written */
+	case SCFW_BOOT_LEDGER:
+		err = board_check_caller_buf(caller_pt, buff, size);
+		if (err == SC_ERR_NONE)
+			err = board_boot_dump(buff, p2);
+		break;
+
+	case SCFW_BOOT_LEDGER_PRINT:
+		board_boot_report();
+		err = SC_ERR_NONE;
+		break;
+
+	case SCFW_DDR_TRAIN_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(ddr_train_stats_t));
+		if (err == SC_ERR_NONE)
+			ddr_train_get_stats((ddr_train_stats_t *)buff);
+		break;
+
+	/* Drop cached training results, next boot trains in full */
+	case SCFW_DDR_TRAIN_DROP:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			ddr_train_invalidate();
+		break;
+
+	case SCFW_DDR_RET_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(ddr_ret_stats_t));
+		if (err == SC_ERR_NONE)
+			ddr_ret_get_stats((ddr_ret_stats_t *)buff);
+		break;
+
+	/* For test_misc */
 	case SOMINFO_READ_EEPROM:
 		always_print("EEPROM Read Function called, address=0x%08x!\n", buff);
 		if (size > 0x100) {
@@ -1916,7 +2438,7 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
 				always_print("EEPROM Read FAIL!\n");
 				break;
 			}
-			SystemTimeDelay(20000U);
+			BOARD_DELAY(20000U);
 			size -= 0x100;
 			buff += 0x100;
 			++i2c_addr;
@@ -1925,7 +2447,7 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
 			always_print("EEPROM Read FAIL!\n");
 			break;
 		}
-		SystemTimeDelay(20000U);
+		BOARD_DELAY(20000U);
 		always_print("EEPROM Read Success!\n");
 		err = SC_ERR_NONE;
 		break;
@@ -1935,37 +2457,18 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
 		for (i = 0; i < 16; i++)
 			always_print("data[%d]=0x%x\n", i, buff[i]);
 		i = 0;
-		if (eeprom_i2c_write(EEPROM_I2C_ADDRESS, 0x00, &i, 0x02)) {
+		if (eeprom_write(EEPROM_I2C_ADDRESS, 0x00, (const uint8_t *)&i, 0x02)) {
 			always_print("EEPROM Magic Erase FAIL!\n");
 			break;
 		}
 
-		SystemTimeDelay(20000U);
-
-		if (eeprom_i2c_write(EEPROM_I2C_ADDRESS, 0x02, buff+0x02, 14)) {
-			always_print("EEPROM Write block 0 FAIL!\n");
+		/* Page-sized writes, each completed by ACK polling */
+		if (eeprom_write(EEPROM_I2C_ADDRESS, 0x02, buff+0x02, 0x1FE)) {
+			always_print("EEPROM Write FAIL!\n");
 			break;
 		}
 
-		for (i = 1; i < 16; i++) {
-			SystemTimeDelay(20000U);
-			if (eeprom_i2c_write(EEPROM_I2C_ADDRESS, i*16, buff+i*16, 16)) {
-				always_print("EEPROM Write block %d FAIL!\n",i);
-				break;
-			}
-		}
-
-		for (i = 0; i < 16; i++) {
-			SystemTimeDelay(20000U);
-			if (eeprom_i2c_write(EEPROM_I2C_ADDRESS+1, i*16, buff+256+i*16, 16)) {
-				always_print("EEPROM Write block %d FAIL!\n",i+16);
-				break;
-			}
-		}
-
-		SystemTimeDelay(20000U);
-
-		if (eeprom_i2c_write(EEPROM_I2C_ADDRESS, 0x00, buff, 0x02)) {
+		if (eeprom_write(EEPROM_I2C_ADDRESS, 0x00, buff, 0x02)) {
 			always_print("EEPROM Magic Write FAIL!\n");
 			break;
 		}
@@ -0,0 +1,39 @@
+#ifndef BOARD_IOCTL_H
+#define BOARD_IOCTL_H
+
+/*
+ * Board ioctl commands, passed in the command word of sc_misc_board_ioctl().
+ * Commands above SOMINFO_WRITE_EEPROM take p1/p2 as described in
+ * board_ioctl().
+ */
+
+#define CTL_CODE(function, method) ((4 << 16) | ((function) << 2) | (method))
+
+#define METHOD_BUFFERED		0
+#define METHOD_NEITHER		3
+
+#define SOMINFO_READ_EEPROM	CTL_CODE(2100, METHOD_BUFFERED)
+#define SOMINFO_WRITE_EEPROM	CTL_CODE(2101, METHOD_BUFFERED)
+#define SCFW_RPC_BATCH		CTL_CODE(2102, METHOD_NEITHER)
+#define SCFW_DDR_PERF_GET	CTL_CODE(2103, METHOD_NEITHER)
+#define SCFW_DVFS_ENABLE	CTL_CODE(2104, METHOD_NEITHER)
+#define SCFW_DVFS_FLOOR		CTL_CODE(2105, METHOD_NEITHER)
+#define SCFW_DVFS_HINT		CTL_CODE(2106, METHOD_NEITHER)
+#define SCFW_DVFS_STATS		CTL_CODE(2107, METHOD_NEITHER)
+#define SCFW_PMIC_RAMP_STATS	CTL_CODE(2108, METHOD_NEITHER)
+#define SCFW_PMIC_IRQ_STATS	CTL_CODE(2111, METHOD_NEITHER)
+#define SCFW_NOTIFY_CONFIG	CTL_CODE(2113, METHOD_NEITHER)
+#define SCFW_NOTIFY_IMMEDIATE	CTL_CODE(2114, METHOD_NEITHER)
+#define SCFW_NOTIFY_STATS	CTL_CODE(2115, METHOD_NEITHER)
+#define SCFW_RPC_REC_DUMP	CTL_CODE(2117, METHOD_NEITHER)
+#define SCFW_RPC_REC_ENABLE	CTL_CODE(2118, METHOD_NEITHER)
+#define SCFW_RM_INDEX		CTL_CODE(2122, METHOD_NEITHER)
+#define SCFW_XRDC_SHADOW_STATS	CTL_CODE(2126, METHOD_NEITHER)
+#define SCFW_BOOT_LEDGER	CTL_CODE(2128, METHOD_NEITHER)
+#define SCFW_BOOT_LEDGER_PRINT	CTL_CODE(2129, METHOD_NEITHER)
+#define SCFW_DDR_TRAIN_STATS	CTL_CODE(2130, METHOD_NEITHER)
+#define SCFW_DDR_TRAIN_DROP	CTL_CODE(2131, METHOD_NEITHER)
+#define SCFW_DDR_RET_STATS	CTL_CODE(2133, METHOD_NEITHER)
+#define SCFW_DDR_PERF_ENABLE	CTL_CODE(2135, METHOD_NEITHER)
+
+#endif
@@ -4,11 +4,14 @@
 #include "main/main.h"
 #include "fsl_device_registers.h"
 #include "drivers/lpi2c/fsl_lpi2c.h"
+#include "drivers/pmic/fsl_i2c_queue.h"
+#include "drivers/sysctr/fsl_sysctr.h"
 #include "fsl_common.h"
 #include "all_svc.h"
 
 #include "pads.h"
 #include "drivers/pad/fsl_pad.h"
+#include "eeprom.h"
 
 /* Local Variables */
 
@@ -96,7 +99,19 @@ status_t eeprom_i2c_write(uint8_t device_addr, uint8_t reg, const void *data, ui
    
     return stat;
 #else
-    return eeprom_i2c_write_sub(device_addr, reg, data, dataLength);
+    status_t stat;
+
+    /* Share the PMIC transaction queue once it is up */
+    if (i2c_queue_active() != SC_FALSE)
+    {
+        stat = i2c_queue_write(device_addr, reg, data, dataLength);
+    }
+    else
+    {
+        stat = eeprom_i2c_write_sub(device_addr, reg, data, dataLength);
+    }
+
+    return stat;
 #endif
 }
 
@@ -192,7 +207,107 @@ status_t eeprom_i2c_read(uint8_t device_addr, uint8_t reg, void *data, uint32_t
     
     return stat;
 #else
-    return eeprom_i2c_read_sub(device_addr, reg, data, dataLength);
+    status_t stat;
+
+    /* Share the PMIC transaction queue once it is up */
+    if (i2c_queue_active() != SC_FALSE)
+    {
+        stat = i2c_queue_read(device_addr, reg, data, dataLength);
+    }
+    else
+    {
+        stat = eeprom_i2c_read_sub(device_addr, reg, data, dataLength);
+    }
+
+    return stat;
 #endif
 }
 
+
+/*--------------------------------------------------------------------------*/
+/* Wait for the EEPROM to finish its internal write cycle                   */
+/*--------------------------------------------------------------------------*/
+status_t eeprom_wait_ready(uint8_t device_addr, uint32_t timeout_us)
+{
+    status_t status;
+    uint32_t start = SYSCTR_GetUsec32();
+
+    /* The device NAKs its address until the write cycle completes, so
+       probe with an address-only transfer until it ACKs or time is up */
+    do
+    {
+        if (i2c_queue_active() != SC_FALSE)
+        {
+            i2c_queue_xfer_t probe;
+
+            i2c_queue_xfer_init(&probe, device_addr, 0U, kLPI2C_Write,
+                NULL, 0U, NULL, NULL);
+            probe.xfer.subaddressSize = 0U;
+
+            status = i2c_queue_submit(&probe);
+            if (status == I32(kStatus_Success))
+            {
+                status = i2c_queue_wait(&probe);
+            }
+        }
+        else
+        {
+            status = LPI2C_MasterStart(LPI2C_SC, device_addr, kLPI2C_Write);
+            if (status == I32(kStatus_Success))
+            {
+                status = LPI2C_MasterStop(LPI2C_SC);
+            }
+        }
+
+        if (status != I32(kStatus_LPI2C_Nak))
+        {
+            break;
+        }
+    }
+    while ((SYSCTR_GetUsec32() - start) < timeout_us);
+
+    BOARD_DELAY_RECORD(SYSCTR_GetUsec32() - start);
+
+    if (status == I32(kStatus_LPI2C_Nak))
+    {
+        status = I32(kStatus_Timeout);
+    }
+
+    return status;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Write a buffer to the EEPROM one page at a time                          */
+/*--------------------------------------------------------------------------*/
+status_t eeprom_write(uint8_t device_addr, uint32_t offset,
+    const uint8_t *data, uint32_t dataLength)
+{
+    status_t status = I32(kStatus_Success);
+
+    while ((dataLength > 0U) && (status == I32(kStatus_Success)))
+    {
+        /* Each 256-byte block answers on its own device address */
+        uint8_t addr = U8(device_addr + (offset / EEPROM_BLOCK_SIZE));
+        uint8_t reg = U8(offset % EEPROM_BLOCK_SIZE);
+
+        /* Never cross a page boundary, the device would wrap around */
+        uint32_t len = EEPROM_PAGE_SIZE - (offset % EEPROM_PAGE_SIZE);
+
+        if (len > dataLength)
+        {
+            len = dataLength;
+        }
+
+        status = eeprom_i2c_write(addr, reg, data, len);
+        if (status == I32(kStatus_Success))
+        {
+            status = eeprom_wait_ready(addr, EEPROM_WRITE_TIMEOUT_US);
+        }
+
+        offset += len;
+        data = &data[len];
+        dataLength -= len;
+    }
+
+    return status;
+}
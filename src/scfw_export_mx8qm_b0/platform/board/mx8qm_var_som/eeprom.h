@@ -3,15 +3,13 @@
 
 #define EEPROM_I2C_ADDRESS	0x52
 
-#define CTL_CODE(function, method) ((4 << 16) | ((function) << 2) | (method))
-
-#define METHOD_BUFFERED		0
-#define METHOD_NEITHER		3
-
-#define SOMINFO_READ_EEPROM	CTL_CODE(2100, METHOD_BUFFERED)
-#define SOMINFO_WRITE_EEPROM	CTL_CODE(2101, METHOD_BUFFERED)
+#define EEPROM_PAGE_SIZE	16U	/* Bytes per page write */
+#define EEPROM_BLOCK_SIZE	256U	/* Bytes per device address */
+#define EEPROM_WRITE_TIMEOUT_US	10000U	/* Upper bound on tWR (5 ms max) */
 
 extern status_t eeprom_i2c_write(uint8_t device_addr, uint8_t reg, const void *data, uint32_t dataLength);
 extern status_t eeprom_i2c_read(uint8_t device_addr, uint8_t reg, void *data, uint32_t dataLength);
+extern status_t eeprom_wait_ready(uint8_t device_addr, uint32_t timeout_us);
+extern status_t eeprom_write(uint8_t device_addr, uint32_t offset, const uint8_t *data, uint32_t dataLength);
 
 #endif
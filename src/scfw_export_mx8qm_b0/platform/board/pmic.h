@@ -79,6 +79,69 @@
 #define FAM_ID_MASK             0xF0U
 /*@}*/
 
+/*!
+ * @name Defines for the voltage ramp engine
+ */
+/*@{*/
+#define PMIC_RAMP_SLOTS         4U      /*!< Pending non-blocking ramps */
+#define PMIC_RAMP_BUCKETS       8U      /*!< Latency histogram buckets */
+#ifndef PMIC_RAMP_POLL_US
+    #define PMIC_RAMP_POLL_US   10U     /*!< Power good poll interval */
+#endif
+#ifndef PMIC_RAMP_WAIT_MAX_US
+    #define PMIC_RAMP_WAIT_MAX_US 1000U /*!< Longest blocking ramp wait */
+#endif
+/*@}*/
+
+/*! Max number of PMIC addresses bound to a driver */
+#define PMIC_MAX_DEVS           4U
+
+/* Types */
+
+/*!
+ * Completion continuation of a non-blocking ramp. Called from the
+ * board worker with SC_ERR_NONE once the regulator reports power good,
+ * or SC_ERR_BUSY if it did not by the deadline.
+ */
+typedef void (*pmic_ramp_cb_t)(pmic_id_t id, uint32_t pmic_reg,
+    sc_err_t err);
+
+/*!
+ * Ramp latency statistics. Bucket n of the histogram counts ramps that
+ * completed in less than 16 << n uS, the last bucket takes the rest.
+ */
+typedef struct
+{
+    uint32_t ramps;                     /*!< Completed ramps */
+    uint32_t timeouts;                  /*!< Ramps past their deadline */
+    uint32_t polls;                     /*!< Power good polls */
+    uint32_t max_usec;                  /*!< Longest ramp */
+    uint32_t hist[PMIC_RAMP_BUCKETS];   /*!< Latency histogram */
+} pmic_ramp_stats_t;
+
+/*!
+ * PMIC driver ops. Each PMIC address is bound to one at probe time so
+ * the dynamic functions dispatch without checking the type. Optional
+ * ops are NULL when the PMIC does not support them.
+ */
+typedef struct
+{
+    sc_err_t (*set_voltage)(pmic_id_t id, uint32_t pmic_reg,
+        uint32_t vol_mv, uint32_t mode_to_set);
+    sc_err_t (*get_voltage)(pmic_id_t id, uint32_t pmic_reg,
+        uint32_t *vol_mv, uint32_t mode_to_get);
+    sc_err_t (*get_pg)(pmic_id_t id, uint32_t pmic_reg, sc_bool_t *pg);
+    sc_err_t (*set_mode)(pmic_id_t id, uint32_t pmic_reg, uint32_t mode);
+    sc_err_t (*get_mode)(pmic_id_t id, uint32_t pmic_reg,
+        uint32_t *mode);                        /*!< Optional */
+    sc_bool_t (*irq_service)(pmic_id_t id);
+    sc_err_t (*register_access)(pmic_id_t id, uint32_t address,
+        sc_bool_t read_write, uint8_t *value);
+    pmic_version_t (*get_version)(pmic_id_t id);
+    uint32_t (*get_temp)(pmic_id_t id);
+    uint32_t (*set_temp_alarm)(pmic_id_t id, uint32_t temp);
+} pmic_ops_t;
+
 /*! Global PMIC type identifier */
 extern uint8_t PMIC_TYPE;
 
@@ -90,6 +153,7 @@ extern uint8_t PMIC_TYPE;
     #define PMIC_GET_MODE           FUNC_PRE(PMIC, _pmic_get_mode)
     #define PMIC_SET_VOLTAGE        FUNC_PRE(PMIC, _pmic_set_voltage)
     #define PMIC_GET_VOLTAGE        FUNC_PRE(PMIC, _pmic_get_voltage)
+    #define PMIC_GET_PG             FUNC_PRE(PMIC, _pmic_get_pg)
     #define PMIC_IRQ_SERVICE        FUNC_PRE(PMIC, _pmic_irq_service)
     #define PMIC_REGISTER_ACCESS    FUNC_PRE(PMIC, _pmic_register_access)
     #define GET_PMIC_VERSION        FUNC_PRE(PMIC, _get_pmic_version)
@@ -98,6 +162,7 @@ extern uint8_t PMIC_TYPE;
 #else /* Point MACROS at the dynamic function for run time decision */
     #define PMIC_SET_VOLTAGE        dynamic_pmic_set_voltage
     #define PMIC_GET_VOLTAGE        dynamic_pmic_get_voltage
+    #define PMIC_GET_PG             dynamic_pmic_get_pg
     #define PMIC_SET_MODE           dynamic_pmic_set_mode
     #define PMIC_GET_MODE           dynamic_pmic_get_mode
     #define PMIC_IRQ_SERVICE        dynamic_pmic_irq_service
@@ -107,6 +172,39 @@ extern uint8_t PMIC_TYPE;
     #define SET_PMIC_TEMP_ALARM     dynamic_set_pmic_temp_alarm
 #endif
 
+/*!
+ * This function binds a PMIC address to the driver for a PMIC type.
+ * Boards call it for each PMIC found so the dynamic functions never
+ * probe.
+ *
+ * @param[in]     id            I2C address of PMIC device
+ * @param[in]     type          PMIC type (e.g. PF8100, PMIC_NONE if absent)
+ *
+ * @return Returns an error code (SC_ERR_NONE = success)
+ *
+ * Return errors:
+ * - SC_ERR_UNAVAILABLE if PMIC_MAX_DEVS addresses are already bound
+ */
+sc_err_t pmic_register(pmic_id_t id, uint8_t type);
+
+/*!
+ * This function reads the device ID at a PMIC address and binds the
+ * address to the matching driver. Called by the dynamic functions on
+ * the first use of an unbound address when PMIC_TYPE is not set.
+ *
+ * @param[in]     id            I2C address of PMIC device
+ *
+ * @return Returns the PMIC type found (PMIC_NONE if none).
+ */
+uint8_t pmic_probe(pmic_id_t id);
+
+/*!
+ * This function returns the number of device ID probes done so far
+ *
+ * @return Returns the probe count.
+ */
+uint32_t pmic_get_probes(void);
+
 /*!
  * This function sets the voltage of a corresponding voltage regulator for the
  * supported PMIC types
@@ -147,6 +245,22 @@ sc_err_t dynamic_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg, uint32_t vol_
 sc_err_t dynamic_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg, uint32_t *vol_mv,
 		uint32_t mode_to_get);
 
+/*!
+ * This function gets the power good state of a regulator
+ *
+ * @param[in]     id            I2C address of PMIC device
+ * @param[in]     pmic_reg      Register corresponding to regulator
+ *                              e.g [pf8100_vregs_t](@ref pf8100_vregs_t)
+ * @param[out]    pg            SC_TRUE if the output is within its window
+ *
+ * @return Returns an error code (SC_ERR_NONE = success)
+ *
+ * Return errors:
+ * - SC_ERR_PARM if invalid parameters
+ * - SC_ERR_UNAVAILABLE if the PMIC has no power good sense
+ */
+sc_err_t dynamic_pmic_get_pg(pmic_id_t id, uint32_t pmic_reg, sc_bool_t *pg);
+
 /*!
  * This function sets the mode of the specified regulator.
  *
@@ -242,6 +356,68 @@ uint32_t dynamic_get_pmic_temp(pmic_id_t id);
  */
  uint32_t dynamic_set_pmic_temp_alarm(pmic_id_t id, uint32_t temp);
 
+/*!
+ * This function returns the expected settle time of a voltage change
+ *
+ * @param[in]     old_mv        voltage before the change in millivolts
+ * @param[in]     new_mv        voltage after the change in millivolts
+ * @param[in]     rate          slew rate in uV per uS
+ *
+ * @return Returns the time in uS (rounded up, 0 if no change)
+ */
+uint32_t pmic_ramp_time(uint32_t old_mv, uint32_t new_mv, uint32_t rate);
+
+/*!
+ * This function waits for regulators to settle. It waits \a settle_us
+ * then polls power good of each rail until \a timeout_us from the call.
+ * Without power good sense it returns after \a settle_us.
+ *
+ * It busy-waits, so call it only where blocking is allowed (thread or
+ * RPC context, not the board tick). \a timeout_us is clamped to
+ * PMIC_RAMP_WAIT_MAX_US and \a settle_us to the timeout, which bounds
+ * the wait to PMIC_RAMP_WAIT_MAX_US plus one poll.
+ *
+ * @param[in]     id            I2C addresses of the PMIC devices
+ * @param[in]     pmic_reg      Registers corresponding to the regulators
+ * @param[in]     num           number of regulators
+ * @param[in]     settle_us     time before the first poll in uS
+ * @param[in]     timeout_us    deadline in uS
+ *
+ * @return Returns an error code (SC_ERR_NONE = success)
+ *
+ * Return errors:
+ * - SC_ERR_BUSY if power good was not reached by the deadline
+ * - SC_ERR_FAIL if reading the PMIC failed
+ */
+sc_err_t pmic_ramp_wait(const pmic_id_t *id, const uint32_t *pmic_reg,
+    uint32_t num, uint32_t settle_us, uint32_t timeout_us);
+
+/*!
+ * This function tracks a ramp without blocking. The board tick posts
+ * the power good poll to the board worker every mS, so the PMIC is
+ * never read in interrupt context, and \a cb runs on completion.
+ *
+ * @param[in]     id            I2C address of PMIC device
+ * @param[in]     pmic_reg      Register corresponding to regulator
+ * @param[in]     settle_us     time before the first poll in uS
+ * @param[in]     timeout_us    deadline in uS
+ * @param[in]     cb            continuation (may be NULL)
+ *
+ * @return Returns an error code (SC_ERR_NONE = success)
+ *
+ * Return errors:
+ * - SC_ERR_UNAVAILABLE if all PMIC_RAMP_SLOTS are pending
+ */
+sc_err_t pmic_ramp_start(pmic_id_t id, uint32_t pmic_reg, uint32_t settle_us,
+    uint32_t timeout_us, pmic_ramp_cb_t cb);
+
+/*!
+ * This function returns the voltage ramp latency statistics
+ *
+ * @param[out]    stats         statistics to fill in
+ */
+void pmic_ramp_get_stats(pmic_ramp_stats_t *stats);
+
  /**@}*/
 
  #endif /* SC_PMIC_H */
@@ -0,0 +1,151 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+
+
+/*==========================================================================*/
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Implementation of the board resource ownership index.
+ */
+/*==========================================================================*/
+
+/* Includes */
+
+#include "main/main.h"
+#include "main/board.h"
+#include "all_svc.h"
+#include "board/rm_index.h"
+
+/*--------------------------------------------------------------------------*/
+/* Snapshot resources and pads owned by a partition                         */
+/*--------------------------------------------------------------------------*/
+void rm_index_build(sc_rm_pt_t pt, rm_index_t *idx)
+{
+    sc_rsrc_t rsrc;
+    sc_pad_t pad;
+    uint32_t i;
+
+    for (i = 0U; i < RM_INDEX_RSRC_WORDS; i++)
+    {
+        idx->rsrc[i] = 0U;
+    }
+    for (i = 0U; i < RM_INDEX_PAD_WORDS; i++)
+    {
+        idx->pad[i] = 0U;
+    }
+
+    for (rsrc = 0U; rsrc < SC_R_LAST; rsrc++)
+    {
+        sc_rm_idx_t ridx;
+        sc_rm_pt_t owner;
+
+        if (rm_check_map_ridx(rsrc, &ridx) != SC_FALSE)
+        {
+            rm_get_ridx_owner(ridx, &owner);
+            if (owner == pt)
+            {
+                idx->rsrc[rsrc / 32U] |= BIT(rsrc);
+            }
+        }
+    }
+
+    for (pad = 0U; pad < SC_NUM_PAD; pad++)
+    {
+        sc_rm_pt_t owner;
+
+        if ((rm_get_pad_owner(pad, &owner) == SC_ERR_NONE)
+            && (owner == pt))
+        {
+            idx->pad[pad / 32U] |= BIT(pad);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Test if a resource is owned                                              */
+/*--------------------------------------------------------------------------*/
+sc_bool_t rm_index_owned(const rm_index_t *idx, sc_rsrc_t rsrc)
+{
+    sc_bool_t rtn = SC_FALSE;
+
+    if ((rsrc < SC_R_LAST) && ((idx->rsrc[rsrc / 32U] & BIT(rsrc)) != 0U))
+    {
+        rtn = SC_TRUE;
+    }
+
+    return rtn;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Test if a pad is owned                                                   */
+/*--------------------------------------------------------------------------*/
+sc_bool_t rm_index_pad_owned(const rm_index_t *idx, sc_pad_t pad)
+{
+    sc_bool_t rtn = SC_FALSE;
+
+    if ((pad < SC_NUM_PAD) && ((idx->pad[pad / 32U] & BIT(pad)) != 0U))
+    {
+        rtn = SC_TRUE;
+    }
+
+    return rtn;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Count owned resources                                                    */
+/*--------------------------------------------------------------------------*/
+uint32_t rm_index_count(const rm_index_t *idx)
+{
+    uint32_t cnt = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < RM_INDEX_RSRC_WORDS; i++)
+    {
+        uint32_t w = idx->rsrc[i];
+
+        /* Clear the lowest set bit until none left */
+        while (w != 0U)
+        {
+            w &= w - 1U;
+            cnt++;
+        }
+    }
+
+    return cnt;
+}
+
@@ -0,0 +1,622 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Implementation of the board XRDC shadow.
+ */
+/*==========================================================================*/
+
+/* Includes */
+
+#include "main/main.h"
+#include "main/board.h"
+#include "board/xrdc_shadow.h"
+
+/* Local Defines */
+
+/* Descriptor key: used, grant pass, MSC, DSC and index */
+#define XS_USED             BIT(31)
+#define XS_GRANT            BIT(30)
+#define XS_MSC              BIT(24)
+#define XS_KEY(K, D, I)     (XS_USED | (K) | (U32(D) << 16U) | U32(I))
+#define XS_DSC(K)           U8(((K) >> 16U) & 0xFFU)
+#define XS_IDX(K)           U16((K) & 0xFFFFU)
+
+/* Descriptor value: 3-bit permission per domain, valid and lock */
+#define XS_PERM_W           3U
+#define XS_PERM_MASK        0x7U
+#define XS_PERMS            0xFFFFFFFFFFFFULL
+#define XS_VALID            (1ULL << 48U)
+#define XS_LOCK             (1ULL << 49U)
+
+/* Driver Functions (resolved by the linker --wrap option) */
+
+void __real_XRDC_Init(sc_dsc_t dsc);
+sc_bool_t __real_XRDC_Config(sc_dsc_t dsc, sc_bool_t mst_enable,
+    sc_bool_t chk_enable);
+void __real_XRDC_GetMsc(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms);
+void __real_XRDC_SetMsc(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, const xrdc_perm_t *perms);
+void __real_XRDC_SetMultiMsc(sc_dsc_t dsc, xrdc_idx_t start,
+    xrdc_idx_t num, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms);
+void __real_XRDC_SetMda(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, sc_rm_spa_t sa, sc_rm_spa_t pa, xrdc_did_t did,
+    xrdc_sid_t sid, xrdc_match_t match, xrdc_match_t mask,
+    sc_bool_t has_match, uint32_t *cache);
+void __real_XRDC_GetPdac(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms);
+void __real_XRDC_SetPdac(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, const xrdc_perm_t *perms, sc_bool_t no_update);
+void __real_XRDC_SetMultiPdac(sc_dsc_t dsc, xrdc_idx_t start,
+    xrdc_idx_t num, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms, sc_bool_t no_update);
+void __real_XRDC_SetMrc(sc_dsc_t dsc, xrdc_idx_t idx, sc_faddr_t start,
+    sc_faddr_t end, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms, xrdc_det_t det, xrdc_rmsg_t rmsg,
+    uint32_t *cache);
+void __real_XRDC_InvalidateMrc(sc_dsc_t dsc, xrdc_idx_t idx,
+    xrdc_idx_t regions, uint32_t *cache);
+
+/* Local Functions */
+
+static uint64_t xrdc_shadow_pack(sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms);
+static void xrdc_shadow_unpack(uint64_t val, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms);
+static sc_bool_t xrdc_shadow_revokes(uint64_t old, uint64_t val);
+static uint32_t xrdc_shadow_slot(uint32_t key);
+static uint32_t xrdc_shadow_find(uint32_t key);
+static void xrdc_shadow_put(uint32_t key, uint64_t val,
+    sc_bool_t no_update);
+static void xrdc_shadow_set(uint32_t key, uint32_t num, uint64_t val,
+    sc_bool_t no_update);
+static void xrdc_shadow_get(uint32_t key, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms);
+static void xrdc_shadow_barrier(void);
+static void xrdc_shadow_flush(void);
+static void xrdc_shadow_hw_get(uint32_t key, uint64_t *val);
+static void xrdc_shadow_hw_set(uint32_t key, uint32_t num, uint64_t val,
+    sc_bool_t no_update);
+
+/* Local Variables */
+
+static uint32_t xrdc_shadow_key[XRDC_SHADOW_SIZE];
+static uint64_t xrdc_shadow_val[XRDC_SHADOW_SIZE];
+static uint32_t xrdc_shadow_num = 0U;
+static uint32_t xrdc_shadow_depth = 0U;
+static xrdc_shadow_stats_t xrdc_shadow_stats;
+
+/*--------------------------------------------------------------------------*/
+/* Open a shadow window                                                     */
+/*--------------------------------------------------------------------------*/
+void xrdc_shadow_begin(void)
+{
+    ENTER_CS;
+    xrdc_shadow_depth++;
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Close a shadow window                                                    */
+/*--------------------------------------------------------------------------*/
+void xrdc_shadow_commit(void)
+{
+    ENTER_CS;
+    if (xrdc_shadow_depth != 0U)
+    {
+        xrdc_shadow_depth--;
+        if (xrdc_shadow_depth == 0U)
+        {
+            xrdc_shadow_flush();
+        }
+    }
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get shadow statistics                                                    */
+/*--------------------------------------------------------------------------*/
+void xrdc_shadow_get_stats(xrdc_shadow_stats_t *stats)
+{
+    *stats = xrdc_shadow_stats;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Link-time wrappers                                                       */
+/*--------------------------------------------------------------------------*/
+void __wrap_XRDC_Init(sc_dsc_t dsc)
+{
+    xrdc_shadow_barrier();
+    __real_XRDC_Init(dsc);
+}
+
+sc_bool_t __wrap_XRDC_Config(sc_dsc_t dsc, sc_bool_t mst_enable,
+    sc_bool_t chk_enable)
+{
+    xrdc_shadow_barrier();
+    return __real_XRDC_Config(dsc, mst_enable, chk_enable);
+}
+
+void __wrap_XRDC_GetMsc(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms)
+{
+    xrdc_shadow_get(XS_KEY(XS_MSC, dsc, idx), valid, lock, perms);
+}
+
+void __wrap_XRDC_SetMsc(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, const xrdc_perm_t *perms)
+{
+    xrdc_shadow_set(XS_KEY(XS_MSC, dsc, idx), 1U,
+        xrdc_shadow_pack(valid, lock, perms), SC_FALSE);
+}
+
+void __wrap_XRDC_SetMultiMsc(sc_dsc_t dsc, xrdc_idx_t start,
+    xrdc_idx_t num, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms)
+{
+    xrdc_shadow_set(XS_KEY(XS_MSC, dsc, start), U32(num),
+        xrdc_shadow_pack(valid, lock, perms), SC_FALSE);
+}
+
+void __wrap_XRDC_SetMda(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, sc_rm_spa_t sa, sc_rm_spa_t pa, xrdc_did_t did,
+    xrdc_sid_t sid, xrdc_match_t match, xrdc_match_t mask,
+    sc_bool_t has_match, uint32_t *cache)
+{
+    xrdc_shadow_barrier();
+    __real_XRDC_SetMda(dsc, idx, valid, lock, sa, pa, did, sid, match,
+        mask, has_match, cache);
+}
+
+void __wrap_XRDC_GetPdac(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms)
+{
+    xrdc_shadow_get(XS_KEY(0U, dsc, idx), valid, lock, perms);
+}
+
+void __wrap_XRDC_SetPdac(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, const xrdc_perm_t *perms, sc_bool_t no_update)
+{
+    xrdc_shadow_set(XS_KEY(0U, dsc, idx), 1U,
+        xrdc_shadow_pack(valid, lock, perms), no_update);
+}
+
+void __wrap_XRDC_SetMultiPdac(sc_dsc_t dsc, xrdc_idx_t start,
+    xrdc_idx_t num, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms, sc_bool_t no_update)
+{
+    xrdc_shadow_set(XS_KEY(0U, dsc, start), U32(num),
+        xrdc_shadow_pack(valid, lock, perms), no_update);
+}
+
+void __wrap_XRDC_SetMrc(sc_dsc_t dsc, xrdc_idx_t idx, sc_faddr_t start,
+    sc_faddr_t end, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms, xrdc_det_t det, xrdc_rmsg_t rmsg,
+    uint32_t *cache)
+{
+    xrdc_shadow_barrier();
+    __real_XRDC_SetMrc(dsc, idx, start, end, valid, lock, perms, det,
+        rmsg, cache);
+}
+
+void __wrap_XRDC_InvalidateMrc(sc_dsc_t dsc, xrdc_idx_t idx,
+    xrdc_idx_t regions, uint32_t *cache)
+{
+    xrdc_shadow_barrier();
+    __real_XRDC_InvalidateMrc(dsc, idx, regions, cache);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Pack a descriptor                                                        */
+/*--------------------------------------------------------------------------*/
+static uint64_t xrdc_shadow_pack(sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms)
+{
+    uint64_t val = 0ULL;
+    uint32_t d;
+
+    for (d = 0U; d < XRDC_MAX_DOMAINS; d++)
+    {
+        val |= U64(perms[d] & XS_PERM_MASK) << (d * XS_PERM_W);
+    }
+    if (valid != SC_FALSE)
+    {
+        val |= XS_VALID;
+    }
+    if (lock != SC_FALSE)
+    {
+        val |= XS_LOCK;
+    }
+
+    return val;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Unpack a descriptor                                                      */
+/*--------------------------------------------------------------------------*/
+static void xrdc_shadow_unpack(uint64_t val, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms)
+{
+    uint32_t d;
+
+    for (d = 0U; d < XRDC_MAX_DOMAINS; d++)
+    {
+        perms[d] = U8(U32(val >> (d * XS_PERM_W)) & XS_PERM_MASK);
+    }
+    *valid = ((val & XS_VALID) != 0ULL) ? SC_TRUE : SC_FALSE;
+    *lock = ((val & XS_LOCK) != 0ULL) ? SC_TRUE : SC_FALSE;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Check if a descriptor change only removes access                         */
+/*--------------------------------------------------------------------------*/
+static sc_bool_t xrdc_shadow_revokes(uint64_t old, uint64_t val)
+{
+    sc_bool_t rtn = SC_TRUE;
+    uint64_t o = ((old & XS_VALID) != 0ULL) ? (old & XS_PERMS) : 0ULL;
+    uint64_t n = ((val & XS_VALID) != 0ULL) ? (val & XS_PERMS) : 0ULL;
+    uint32_t d;
+
+    /* Each domain must keep its permission or lose it */
+    for (d = 0U; d < XRDC_MAX_DOMAINS; d++)
+    {
+        uint32_t np = U32(n >> (d * XS_PERM_W)) & XS_PERM_MASK;
+        uint32_t op = U32(o >> (d * XS_PERM_W)) & XS_PERM_MASK;
+
+        if ((np != 0U) && (np != op))
+        {
+            rtn = SC_FALSE;
+        }
+    }
+
+    return rtn;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Slot of a descriptor                                                     */
+/*--------------------------------------------------------------------------*/
+static uint32_t xrdc_shadow_slot(uint32_t key)
+{
+    uint32_t slot = U32(XS_IDX(key)) + (U32(XS_DSC(key)) * 37U);
+
+    /* Linear in the index so runs land in consecutive slots */
+    if ((key & XS_MSC) != 0U)
+    {
+        slot += 17U;
+    }
+
+    return slot & (XRDC_SHADOW_SIZE - 1U);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Find a held descriptor, returns XRDC_SHADOW_SIZE if not held             */
+/*--------------------------------------------------------------------------*/
+static uint32_t xrdc_shadow_find(uint32_t key)
+{
+    uint32_t slot = xrdc_shadow_slot(key);
+
+    if ((xrdc_shadow_key[slot] & ~XS_GRANT) != key)
+    {
+        slot = XRDC_SHADOW_SIZE;
+    }
+
+    return slot;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Hold a descriptor write                                                  */
+/*--------------------------------------------------------------------------*/
+static void xrdc_shadow_put(uint32_t key, uint64_t val,
+    sc_bool_t no_update)
+{
+    uint32_t slot = xrdc_shadow_slot(key);
+    uint64_t cur = 0ULL;
+
+    /* Slot holds another descriptor, flush rather than reorder it */
+    if (((xrdc_shadow_key[slot] & XS_USED) != 0U)
+        && ((xrdc_shadow_key[slot] & ~XS_GRANT) != key))
+    {
+        xrdc_shadow_stats.early++;
+        xrdc_shadow_flush();
+    }
+
+    if (no_update != SC_FALSE)
+    {
+        if (xrdc_shadow_key[slot] == key)
+        {
+            cur = xrdc_shadow_val[slot];
+        }
+        else
+        {
+            xrdc_shadow_hw_get(key, &cur);
+        }
+    }
+
+    /* Same rule as the driver, no_update keeps a valid descriptor */
+    if ((no_update == SC_FALSE) || ((cur & XS_VALID) == 0ULL))
+    {
+        if (xrdc_shadow_key[slot] != key)
+        {
+            xrdc_shadow_num++;
+        }
+        xrdc_shadow_key[slot] = key;
+        xrdc_shadow_val[slot] = val;
+        xrdc_shadow_stats.captured++;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Write descriptors, held if a window is open                              */
+/*--------------------------------------------------------------------------*/
+static void xrdc_shadow_set(uint32_t key, uint32_t num, uint64_t val,
+    sc_bool_t no_update)
+{
+    if (xrdc_shadow_depth == 0U)
+    {
+        xrdc_shadow_hw_set(key, num, val, no_update);
+    }
+    else
+    {
+        sc_bool_t hold = SC_TRUE;
+
+        #ifndef SIMU
+            /* Writes from an interrupt are not part of the window */
+            if (__get_IPSR() != 0U)
+            {
+                hold = SC_FALSE;
+            }
+        #endif
+
+        if (hold != SC_FALSE)
+        {
+            uint32_t i;
+
+            ENTER_CS;
+            for (i = 0U; i < num; i++)
+            {
+                xrdc_shadow_put(key + i, val, no_update);
+            }
+            EXIT_CS;
+        }
+        else
+        {
+            xrdc_shadow_barrier();
+            xrdc_shadow_hw_set(key, num, val, no_update);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Read a descriptor, held value first                                      */
+/*--------------------------------------------------------------------------*/
+static void xrdc_shadow_get(uint32_t key, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms)
+{
+    uint64_t val;
+
+    if (xrdc_shadow_depth == 0U)
+    {
+        xrdc_shadow_hw_get(key, &val);
+    }
+    else
+    {
+        uint32_t slot;
+
+        ENTER_CS;
+        slot = xrdc_shadow_find(key);
+        if (slot < XRDC_SHADOW_SIZE)
+        {
+            val = xrdc_shadow_val[slot];
+        }
+        else
+        {
+            xrdc_shadow_hw_get(key, &val);
+        }
+        EXIT_CS;
+    }
+
+    xrdc_shadow_unpack(val, valid, lock, perms);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Flush held writes before a write the shadow doesn't hold                 */
+/*--------------------------------------------------------------------------*/
+static void xrdc_shadow_barrier(void)
+{
+    if (xrdc_shadow_depth != 0U)
+    {
+        ENTER_CS;
+        if (xrdc_shadow_num != 0U)
+        {
+            xrdc_shadow_stats.early++;
+            xrdc_shadow_flush();
+        }
+        EXIT_CS;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Write held descriptors to the hardware                                   */
+/*--------------------------------------------------------------------------*/
+static void xrdc_shadow_flush(void)
+{
+    uint32_t slot;
+    uint32_t pass;
+
+    if (xrdc_shadow_num != 0U)
+    {
+        xrdc_shadow_stats.commits++;
+
+        /* Drop descriptors the hardware already has, mark grants */
+        for (slot = 0U; slot < XRDC_SHADOW_SIZE; slot++)
+        {
+            uint32_t key = xrdc_shadow_key[slot];
+
+            if ((key & XS_USED) != 0U)
+            {
+                uint64_t hw;
+
+                xrdc_shadow_hw_get(key, &hw);
+                if (hw == xrdc_shadow_val[slot])
+                {
+                    xrdc_shadow_key[slot] = 0U;
+                    xrdc_shadow_num--;
+                    xrdc_shadow_stats.skipped++;
+                }
+                else if (xrdc_shadow_revokes(hw, xrdc_shadow_val[slot])
+                    == SC_FALSE)
+                {
+                    xrdc_shadow_key[slot] = key | XS_GRANT;
+                }
+                else
+                {
+                    ; /* Intentional empty else */
+                }
+            }
+        }
+
+        /* Remove access first, then grant it */
+        for (pass = 0U; pass < 2U; pass++)
+        {
+            uint32_t grant = (pass == 0U) ? 0U : XS_GRANT;
+
+            slot = 0U;
+            while (slot < XRDC_SHADOW_SIZE)
+            {
+                uint32_t key = xrdc_shadow_key[slot];
+                uint32_t run = 1U;
+
+                if (((key & XS_USED) != 0U) && ((key & XS_GRANT) == grant))
+                {
+                    uint64_t val = xrdc_shadow_val[slot];
+                    uint32_t i;
+
+                    /* Extend over the next indexes with the same value */
+                    while (((slot + run) < XRDC_SHADOW_SIZE)
+                        && (xrdc_shadow_key[slot + run] == (key + run))
+                        && (xrdc_shadow_val[slot + run] == val))
+                    {
+                        run++;
+                    }
+
+                    xrdc_shadow_hw_set(key, run, val, SC_FALSE);
+
+                    for (i = 0U; i < run; i++)
+                    {
+                        xrdc_shadow_key[slot + i] = 0U;
+                    }
+                    xrdc_shadow_num -= run;
+                    xrdc_shadow_stats.written += run;
+                    if (run > 1U)
+                    {
+                        xrdc_shadow_stats.multi++;
+                    }
+                }
+                slot += run;
+            }
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Read a descriptor from the hardware                                      */
+/*--------------------------------------------------------------------------*/
+static void xrdc_shadow_hw_get(uint32_t key, uint64_t *val)
+{
+    {
+        xrdc_perm_t perms[XRDC_MAX_DOMAINS];
+        sc_bool_t valid;
+        sc_bool_t lock;
+
+        if ((key & XS_MSC) != 0U)
+        {
+            __real_XRDC_GetMsc(XS_DSC(key), XS_IDX(key), &valid, &lock,
+                perms);
+        }
+        else
+        {
+            __real_XRDC_GetPdac(XS_DSC(key), XS_IDX(key), &valid, &lock,
+                perms);
+        }
+        *val = xrdc_shadow_pack(valid, lock, perms);
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Write a run of descriptors to the hardware                               */
+/*--------------------------------------------------------------------------*/
+static void xrdc_shadow_hw_set(uint32_t key, uint32_t num, uint64_t val,
+    sc_bool_t no_update)
+{
+    xrdc_perm_t perms[XRDC_MAX_DOMAINS];
+    sc_bool_t valid;
+    sc_bool_t lock;
+    sc_dsc_t dsc = XS_DSC(key);
+    xrdc_idx_t idx = XS_IDX(key);
+
+    xrdc_shadow_unpack(val, &valid, &lock, perms);
+
+    if ((key & XS_MSC) != 0U)
+    {
+        if (num == 1U)
+        {
+            __real_XRDC_SetMsc(dsc, idx, valid, lock, perms);
+        }
+        else
+        {
+            __real_XRDC_SetMultiMsc(dsc, idx, U16(num), valid, lock,
+                perms);
+        }
+    }
+    else
+    {
+        if (num == 1U)
+        {
+            __real_XRDC_SetPdac(dsc, idx, valid, lock, perms, no_update);
+        }
+        else
+        {
+            __real_XRDC_SetMultiPdac(dsc, idx, U16(num), valid, lock,
+                perms, no_update);
+        }
+    }
+}
+
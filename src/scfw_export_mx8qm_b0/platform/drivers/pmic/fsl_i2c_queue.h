@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2017-2019 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DRV_I2C_QUEUE_H
+#define DRV_I2C_QUEUE_H
+
+/*!
+ * @addtogroup pmic_driver
+ * @{
+ */
+
+/*! @file */
+
+/* Includes */
+
+#include "main/types.h"
+#include "drivers/lpi2c/fsl_lpi2c.h"
+
+/* Defines */
+
+/*! NVIC interrupt used by the PMIC LPI2C */
+#ifndef I2C_QUEUE_IRQn
+    #define I2C_QUEUE_IRQn          LPI2C0_IRQn
+#endif
+
+/*! NVIC priority of the PMIC LPI2C interrupt */
+#ifndef I2C_QUEUE_IRQ_PRIO
+    #define I2C_QUEUE_IRQ_PRIO      SC_SCHED_PRIO_PREEMPT_HIGH
+#endif
+
+/* Types */
+
+/*!
+ * Completion callback for a queued transaction. Called from the LPI2C
+ * interrupt (or from i2c_queue_wait() when the interrupt is masked).
+ */
+typedef void (*i2c_queue_callback_t)(status_t status, void *userData);
+
+/*!
+ * Transaction descriptor. Owned by the caller and must stay valid until
+ * the transaction completes.
+ */
+typedef struct i2c_queue_xfer
+{
+    struct i2c_queue_xfer *next;        /*!< Next queued transaction */
+    lpi2c_master_transfer_t xfer;       /*!< Address, subaddress and buffer */
+    i2c_queue_callback_t callback;      /*!< Completion callback (or NULL) */
+    void *userData;                     /*!< Passed to the callback */
+    volatile status_t status;           /*!< Completion status */
+    volatile sc_bool_t done;            /*!< Set once the status is final */
+} i2c_queue_xfer_t;
+
+/* Functions */
+
+/*!
+ * This function creates the LPI2C master handle and enables the LPI2C
+ * interrupt. Must be called after LPI2C_MasterInit(). A board that uses
+ * the queue must call i2c_queue_irq_handler() from the handler of
+ * I2C_QUEUE_IRQn.
+ */
+void i2c_queue_init(void);
+
+/*!
+ * This function returns if the transaction queue has been initialized.
+ *
+ * @return Returns SC_TRUE if transfers should be queued
+ */
+sc_bool_t i2c_queue_active(void);
+
+/*!
+ * This function fills in a register access descriptor.
+ *
+ * @param[out]      xfer            descriptor to fill in
+ * @param[in]       device_addr     I2C address of device
+ * @param[in]       reg             address of register on device
+ * @param[in]       dir             kLPI2C_Write or kLPI2C_Read
+ * @param[in]       data            data buffer
+ * @param[in]       dataLength      length of data
+ * @param[in]       callback        completion callback (or NULL)
+ * @param[in]       userData        passed to the callback
+ */
+void i2c_queue_xfer_init(i2c_queue_xfer_t *xfer, uint8_t device_addr,
+    uint8_t reg, lpi2c_direction_t dir, void *data, uint32_t dataLength,
+    i2c_queue_callback_t callback, void *userData);
+
+/*!
+ * This function appends a transaction to the queue and returns without
+ * waiting. Completion is reported through the descriptor callback.
+ *
+ * @param[in]       xfer            transaction to queue
+ *
+ * @return Returns kStatus_Success if the transaction was queued
+ */
+status_t i2c_queue_submit(i2c_queue_xfer_t *xfer);
+
+/*!
+ * This function waits for a queued transaction to complete. The SCU
+ * sleeps between interrupts if the LPI2C IRQ can preempt the caller,
+ * otherwise the LPI2C is serviced inline.
+ *
+ * @param[in]       xfer            transaction to wait for
+ *
+ * @return Returns the completion status of the transaction
+ */
+status_t i2c_queue_wait(i2c_queue_xfer_t *xfer);
+
+/*!
+ * This function queues a register write and waits for it to complete.
+ *
+ * @param[in]       device_addr     I2C address of device
+ * @param[in]       reg             address of register on device
+ * @param[in]       data            data to be written
+ * @param[in]       dataLength      length of data to be written
+ *
+ * @return Returns the status of the write (success = kStatus_Success)
+ */
+status_t i2c_queue_write(uint8_t device_addr, uint8_t reg, const void *data,
+    uint32_t dataLength);
+
+/*!
+ * This function queues a register read and waits for it to complete.
+ *
+ * @param[in]       device_addr     I2C address of device
+ * @param[in]       reg             address of register on device
+ * @param[out]      data            data to be read
+ * @param[in]       dataLength      length of data to be read
+ *
+ * @return Returns the status of the read (success = kStatus_Success)
+ */
+status_t i2c_queue_read(uint8_t device_addr, uint8_t reg, void *data,
+    uint32_t dataLength);
+
+/*!
+ * This function services the LPI2C interrupt. Call it from the board
+ * handler of I2C_QUEUE_IRQn.
+ */
+void i2c_queue_irq_handler(void);
+
+#endif
+
+/**@}*/
+
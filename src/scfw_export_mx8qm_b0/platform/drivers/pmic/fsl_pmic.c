@@ -34,6 +34,7 @@
 #include "main/main.h"
 #include "fsl_device_registers.h"
 #include "drivers/pmic/fsl_pmic.h"
+#include "drivers/pmic/fsl_i2c_queue.h"
 #include "drivers/lpi2c/fsl_lpi2c.h"
 #include "fsl_common.h"
 
@@ -44,9 +45,19 @@
 
 uint8_t pf8x00_crc_data(uint8_t addr, uint8_t reg, const uint8_t * const data, 
     uint8_t msg_size);
+static inline uint8_t pf8x00_crc8(uint8_t crc, uint8_t val);
 
 /* Local Variables */
 
+/*!
+ * CRC8 (POLY) of each nibble value, the CRC is advanced 4 bits at a time
+ */
+static const uint8_t pf8x00_crc_nibble[16] =
+{
+    0x00U, 0x1DU, 0x3AU, 0x27U, 0x74U, 0x69U, 0x4EU, 0x53U,
+    0xE8U, 0xF5U, 0xD2U, 0xCFU, 0x9CU, 0x81U, 0xA6U, 0xBBU
+};
+
 /*--------------------------------------------------------------------------*/
 /* Write to the PMIC via the I2C                                            */
 /*--------------------------------------------------------------------------*/
@@ -138,7 +149,19 @@ status_t i2c_write(uint8_t device_addr, uint8_t reg, const void *data,
     
     return stat;
 #else
-    return i2c_write_sub(device_addr, reg, data, dataLength);
+    status_t stat;
+
+    /* Let the LPI2C IRQ run the transfer once the queue is up */
+    if (i2c_queue_active() != SC_FALSE)
+    {
+        stat = i2c_queue_write(device_addr, reg, data, dataLength);
+    }
+    else
+    {
+        stat = i2c_write_sub(device_addr, reg, data, dataLength);
+    }
+
+    return stat;
 #endif
 }
 
@@ -333,6 +356,71 @@ status_t i2c_j1850_read(uint8_t device_addr, uint8_t reg, void *data,
     return status;
 }
 
+/*--------------------------------------------------------------------------*/
+/* Write consecutive PMIC registers via the I2C with per-byte CRC           */
+/*--------------------------------------------------------------------------*/
+status_t i2c_j1850_burst_write(uint8_t device_addr, uint8_t reg,
+    const uint8_t *data, uint8_t dataLength)
+{
+    status_t status = I32(kStatus_InvalidArgument);
+
+    if ((dataLength != 0U) && (dataLength <= PMIC_BURST_MAX))
+    {
+        uint8_t frame[2U * PMIC_BURST_MAX];
+        uint8_t addr = U8(device_addr << 1U);
+        uint8_t n;
+
+        /* Each byte carries the CRC a single register write would */
+        for (n = 0U; n < dataLength; n++)
+        {
+            frame[2U * n] = data[n];
+            frame[(2U * n) + 1U] = pf8x00_crc_data(addr, U8(reg + n),
+                &data[n], 1U);
+        }
+
+        status = i2c_write(device_addr, reg, frame, 2U * U32(dataLength));
+    }
+
+    return status;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Read consecutive PMIC registers via the I2C with per-byte CRC            */
+/*--------------------------------------------------------------------------*/
+status_t i2c_j1850_burst_read(uint8_t device_addr, uint8_t reg,
+    uint8_t *data, uint8_t dataLength)
+{
+    status_t status = I32(kStatus_InvalidArgument);
+
+    if ((dataLength != 0U) && (dataLength <= PMIC_BURST_MAX))
+    {
+        uint8_t frame[2U * PMIC_BURST_MAX];
+        uint8_t addr = U8((device_addr << 1U) | 0x1U);
+        uint8_t n;
+
+        status = i2c_j1850_read(device_addr, reg, frame,
+            U8(2U * dataLength));
+
+        /* Check and strip the CRC following each byte */
+        for (n = 0U; (n < dataLength)
+            && (status == I32(kStatus_Success)); n++)
+        {
+            if (frame[(2U * n) + 1U] != pf8x00_crc_data(addr,
+                U8(reg + n), &frame[2U * n], 1U))
+            {
+                pmic_print(1, "PMIC CRC error reg 0x%x\n", reg + n);
+                status = I32(kStatus_Fail);
+            }
+            else
+            {
+                data[n] = frame[2U * n];
+            }
+        }
+    }
+
+    return status;
+}
+
 /*--------------------------------------------------------------------------*/
 /* Read from the PMIC via I2C                                               */
 /*--------------------------------------------------------------------------*/
@@ -432,7 +520,19 @@ status_t i2c_read(uint8_t device_addr, uint8_t reg, void *data,
     
     return stat;
 #else
-    return i2c_read_sub(device_addr, reg, data, dataLength);
+    status_t stat;
+
+    /* Let the LPI2C IRQ run the transfer once the queue is up */
+    if (i2c_queue_active() != SC_FALSE)
+    {
+        stat = i2c_queue_read(device_addr, reg, data, dataLength);
+    }
+    else
+    {
+        stat = i2c_read_sub(device_addr, reg, data, dataLength);
+    }
+
+    return stat;
 #endif
 }
 
@@ -542,34 +642,17 @@ uint8_t pf8x00_crc_data(uint8_t addr, uint8_t reg, const uint8_t * const data,
 
     if (d != NULL)
     {
-        uint8_t i, j, crc = 0xFFU;
-
-        /* CRC the address first */
-        crc ^= addr;
-        for (i = 0U; i < 8U; i++)
-        {
-            crc = ((crc & 0x80U) != 0U) ? ((crc << 1U) ^ POLY )
-                : U8(crc << 1U);
-        }
+        uint8_t j, crc = 0xFFU;
 
-        /* CRC the register address next */
-        crc ^= reg;
-        for (i = 0U; i < 8U; i++)
-        {
-            crc = ((crc & 0x80U) != 0U) ? ((crc << 1U) ^ POLY )
-                : U8(crc << 1U);
-        }
+        /* CRC the address first, then the register address */
+        crc = pf8x00_crc8(crc, addr);
+        crc = pf8x00_crc8(crc, reg);
 
         j = 0U; /* Finally do the data */
         while (j < msg_size)
         {
-            crc ^= *d;
+            crc = pf8x00_crc8(crc, *d);
             d++;
-            for (i = 0U; i < 8U; i++)
-            {
-                crc = ((crc & 0x80U) != 0U) ? ((crc << 1U) ^ POLY )
-                    : U8(crc << 1U);
-            }
             j++;
         }
 
@@ -579,3 +662,15 @@ uint8_t pf8x00_crc_data(uint8_t addr, uint8_t reg, const uint8_t * const data,
     return rtn;
 }
 
+/*--------------------------------------------------------------------------*/
+/* Advance the j1850 crc by one byte                                        */
+/*--------------------------------------------------------------------------*/
+static inline uint8_t pf8x00_crc8(uint8_t crc, uint8_t val)
+{
+    uint8_t c = crc ^ val;
+
+    c = U8(c << 4U) ^ pf8x00_crc_nibble[c >> 4U];
+
+    return U8(c << 4U) ^ pf8x00_crc_nibble[c >> 4U];
+}
+
@@ -50,6 +50,12 @@
                                      U32(kLPI2C_MasterDataMatchFlag) |              \
                                      U32(kLPI2C_MasterBusyFlag) |                   \
                                      U32(kLPI2C_MasterBusBusyFlag))
+
+/*! Max registers in one secure (CRC) burst transfer */
+#ifndef PMIC_BURST_MAX
+    #define PMIC_BURST_MAX          32U
+#endif
+
 /* Types */
 
 /*!
@@ -150,6 +156,43 @@ status_t i2c_j1850_write(uint8_t device_addr, uint8_t reg, const void *data,
 status_t i2c_j1850_read(uint8_t device_addr, uint8_t reg, void *data,
     uint8_t dataLength);
 
+/*!
+ * This function writes consecutive registers of a PF8x00 in secure
+ * (CRC) mode in one transaction. Each data byte is followed by the CRC
+ * a single register write of it would carry.
+ *
+ * @param[in]       device_addr     I2C address of device
+ * @param[in]       reg             address of first register on device
+ * @param[in]       data            data to be written
+ * @param[in]       dataLength      number of registers (max PMIC_BURST_MAX)
+ *
+ * @return Returns the status of the write (success = kStatus_Success)
+ *
+ * Return errors
+ * - kStatus_InvalidArgument if \a dataLength is 0 or too large
+ * - kStatus_Fail if any of the transactions failed
+ */
+status_t i2c_j1850_burst_write(uint8_t device_addr, uint8_t reg,
+    const uint8_t *data, uint8_t dataLength);
+
+/*!
+ * This function reads consecutive registers of a PF8x00 in secure
+ * (CRC) mode in one transaction, checking the CRC after each byte.
+ *
+ * @param[in]       device_addr     I2C address of device
+ * @param[in]       reg             address of first register on device
+ * @param[out]      data            data read
+ * @param[in]       dataLength      number of registers (max PMIC_BURST_MAX)
+ *
+ * @returns Returns the status of the read (success = kStatus_Success)
+ *
+ * Return errors
+ * - kStatus_InvalidArgument if \a dataLength is 0 or too large
+ * - kStatus_Fail if any transaction failed or a CRC did not match
+ */
+status_t i2c_j1850_burst_read(uint8_t device_addr, uint8_t reg,
+    uint8_t *data, uint8_t dataLength);
+
 /*!
  * This function reads the register at address 0x0 for the Device ID
  *
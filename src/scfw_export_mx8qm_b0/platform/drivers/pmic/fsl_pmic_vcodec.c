@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2017-2019 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Includes */
+
+#include "main/scfw.h"
+#include "main/main.h"
+#include "drivers/pmic/fsl_pmic_vcodec.h"
+
+/* Local Functions */
+
+static uint8_t pmic_vcodec_lower(const pmic_vcodec_t *codec,
+    uint32_t vol_mv);
+
+/*--------------------------------------------------------------------------*/
+/* Build a codec                                                            */
+/*--------------------------------------------------------------------------*/
+void pmic_vcodec_init(pmic_vcodec_t *codec, const uint32_t *mv,
+    uint8_t num)
+{
+    uint8_t i;
+
+    codec->mv = mv;
+    codec->num = (num > PMIC_VCODEC_MAX) ? U8(PMIC_VCODEC_MAX) : num;
+
+    /* Stable insertion sort, equal voltages keep code order */
+    for (i = 0U; i < codec->num; i++)
+    {
+        uint8_t j = i;
+
+        while ((j > 0U) && (mv[codec->order[j - 1U]] > mv[i]))
+        {
+            codec->order[j] = codec->order[j - 1U];
+            j--;
+        }
+        codec->order[j] = i;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get the voltage of a code                                                */
+/*--------------------------------------------------------------------------*/
+uint32_t pmic_vcodec_decode(const pmic_vcodec_t *codec, uint8_t code)
+{
+    uint32_t vol_mv = 0U;
+
+    if (code < codec->num)
+    {
+        vol_mv = codec->mv[code];
+    }
+
+    return vol_mv;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Find the code of an exact voltage                                        */
+/*--------------------------------------------------------------------------*/
+sc_bool_t pmic_vcodec_find(const pmic_vcodec_t *codec, uint32_t vol_mv,
+    uint8_t *code)
+{
+    uint8_t pos = pmic_vcodec_lower(codec, vol_mv);
+    sc_bool_t found = SC_FALSE;
+
+    if ((pos < codec->num) && (codec->mv[codec->order[pos]] == vol_mv))
+    {
+        *code = codec->order[pos];
+        found = SC_TRUE;
+    }
+
+    return found;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Find the code of the lowest voltage at or above a voltage                */
+/*--------------------------------------------------------------------------*/
+sc_bool_t pmic_vcodec_ceil(const pmic_vcodec_t *codec, uint32_t vol_mv,
+    uint8_t *code)
+{
+    uint8_t pos = pmic_vcodec_lower(codec, vol_mv);
+    sc_bool_t found = SC_FALSE;
+
+    if (pos < codec->num)
+    {
+        *code = codec->order[pos];
+        found = SC_TRUE;
+    }
+
+    return found;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Position of the first voltage not below vol_mv                           */
+/*--------------------------------------------------------------------------*/
+static uint8_t pmic_vcodec_lower(const pmic_vcodec_t *codec,
+    uint32_t vol_mv)
+{
+    uint8_t lo = 0U;
+    uint8_t hi = codec->num;
+
+    while (lo < hi)
+    {
+        uint8_t mid = U8((U32(lo) + U32(hi)) / 2U);
+
+        if (codec->mv[codec->order[mid]] < vol_mv)
+        {
+            lo = mid + 1U;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
@@ -34,6 +34,7 @@
 #include "main/main.h"
 #include "fsl_device_registers.h"
 #include "drivers/pmic/fsl_pmic.h"
+#include "drivers/pmic/fsl_pmic_shadow.h"
 #include "drivers/lpi2c/fsl_lpi2c.h"
 #include "drivers/pmic/pf100/fsl_pf100.h"
 #include "fsl_common.h"
@@ -45,6 +46,9 @@
 #define SW_BIT6_MASK         0x40U /*!< Voltage Range selection bit mask */
 #define SW_MODE_MASK         0xFU
 #define VGEN_MODE_MASK       (0x7U << 4U)
+#define SHADOW_START         0x1AU /*!< Registers below hold IDs and IRQ latches */
+#define PAGE_REG             0x7FU /*!< Selects the page seen from PAGE_START */
+#define PAGE_START           0x80U /*!< First register of the selected page */
 
 /* Defines */
 
@@ -99,6 +103,9 @@ typedef uint8_t pmic_ints_t;
 
 /* Local Functions */
 
+static status_t pf100_reg_read(pmic_id_t id, uint8_t reg, uint8_t *val);
+static status_t pf100_reg_write(pmic_id_t id, uint8_t reg, uint8_t val);
+
 /* Local Variables */
 
 struct sw_range
@@ -182,7 +189,7 @@ sc_err_t pf100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
         case SW2:/* variable step size based on operating range determined by SW2[6] */
             if (switching_range.sw2 == 0U)
             {
-                if (i2c_read(id, pmic_reg8, &val, 1U) != kStatus_Success)
+                if (pf100_reg_read(id, pmic_reg8, &val) != kStatus_Success)
                 {
                     return SC_ERR_FAIL; /* return if voltage range read failed */
                 }
@@ -205,7 +212,7 @@ sc_err_t pf100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
         case SW3A:
             if (switching_range.sw3a == 0U)
             {
-                if (i2c_read(id, pmic_reg8, &val, 1U) != kStatus_Success)
+                if (pf100_reg_read(id, pmic_reg8, &val) != kStatus_Success)
                 {
                     return SC_ERR_FAIL; /* return if voltage range read failed */
                 }
@@ -228,7 +235,7 @@ sc_err_t pf100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
         case SW3B:
             if (switching_range.sw3b == 0U)
             {
-                if (i2c_read(id, pmic_reg8, &val, 1U) != kStatus_Success)
+                if (pf100_reg_read(id, pmic_reg8, &val) != kStatus_Success)
                 {
                     return SC_ERR_FAIL; /* return if voltage range read failed */
                 }
@@ -251,7 +258,7 @@ sc_err_t pf100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
         case SW4:
             if (switching_range.sw4 == 0U)
             {
-                if (i2c_read(id, pmic_reg8, &val, 1U) != kStatus_Success)
+                if (pf100_reg_read(id, pmic_reg8, &val) != kStatus_Success)
                 {
                     return SC_ERR_FAIL; /* return if voltage range read failed */
                 }
@@ -297,7 +304,7 @@ sc_err_t pf100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
     }
 
     /* Read PMIC register */
-    err = i2c_read(id, pmic_reg8 + mode_offset, &val, 1U);
+    err = pf100_reg_read(id, U8(pmic_reg8 + mode_offset), &val);
     if (err != kStatus_Success)
     {
         error_print("pmic_set_volt - Fail I2C rd volt PMIC %d, reg %u\n",
@@ -307,11 +314,11 @@ sc_err_t pf100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
     }
 
     /* Update voltage */
-    val &= ~volt_mask;
-    val |= new_volt;
+    val &= U8(~volt_mask);
+    val |= U8(new_volt);
 
     /* Update PMIC register */
-    err = i2c_write(id, pmic_reg8 + mode_offset, &val, 1U);
+    err = pf100_reg_write(id, U8(pmic_reg8 + mode_offset), val);
     if (err != kStatus_Success)
     {
         error_print("pmic_set_volt - Fail to set volt PMIC %d, reg %u\n",
@@ -357,7 +364,7 @@ sc_err_t pf100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
     }
 
     /* Read PMIC register */
-    err = i2c_read(id, pmic_reg8 + mode_offset, &val, 1U);
+    err = pf100_reg_read(id, U8(pmic_reg8 + mode_offset), &val);
     if (err != kStatus_Success)
     {
         error_print("pmic_get_volt - Fail I2C rd volt PMIC %d, reg %u\n",
@@ -378,7 +385,7 @@ sc_err_t pf100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
             val &= SW_VOLT_MASK;
             if (switching_range.sw2 == 0U)
             {
-                if (i2c_read(id, pmic_reg8, &val2, 1) != kStatus_Success)
+                if (pf100_reg_read(id, pmic_reg8, &val2) != kStatus_Success)
                 {
                     return SC_ERR_FAIL; /* return if voltage range read failed */
                 }
@@ -398,7 +405,7 @@ sc_err_t pf100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
             val &= SW_VOLT_MASK;
             if (switching_range.sw3a == 0U)
             {
-                if (i2c_read(id, pmic_reg8, &val2, 1) != kStatus_Success)
+                if (pf100_reg_read(id, pmic_reg8, &val2) != kStatus_Success)
                 {
                     return SC_ERR_FAIL; /* return if voltage range read failed */
                 }
@@ -418,7 +425,7 @@ sc_err_t pf100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
             val &= SW_VOLT_MASK;
             if (switching_range.sw3b == 0U)
             {
-                if (i2c_read(id, pmic_reg8, &val2, 1) != kStatus_Success)
+                if (pf100_reg_read(id, pmic_reg8, &val2) != kStatus_Success)
                 {
                     return SC_ERR_FAIL; /* return if voltage range read failed */
                 }
@@ -438,7 +445,7 @@ sc_err_t pf100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
             val &= SW_VOLT_MASK;
             if (switching_range.sw4 == 0U)
             {
-                if (i2c_read(id, pmic_reg8, &val2, 1) != kStatus_Success)
+                if (pf100_reg_read(id, pmic_reg8, &val2) != kStatus_Success)
                 {
                     return SC_ERR_FAIL; /* return if voltage range read failed */
                 }
@@ -480,7 +487,7 @@ sc_err_t pf100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
 sc_err_t pf100_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
 {
     status_t err;
-    uint32_t val = 0U;
+    uint8_t val = 0U;
     uint32_t mask = VGEN_MODE_MASK;
     uint8_t pmic_reg8;
 
@@ -525,7 +532,7 @@ sc_err_t pf100_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
     }
     
     /* Read PMIC register */
-    err = i2c_read(id, pmic_reg8, &val, 1U);
+    err = pf100_reg_read(id, pmic_reg8, &val);
     if (err != kStatus_Success)
      {
         error_print("pmic_set_mode - Fail to read PMIC %d, reg %u\n",
@@ -535,11 +542,11 @@ sc_err_t pf100_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
     }
 
     /* Update mode */
-    val &= ~mask;
-    val |= mode;
+    val &= U8(~mask);
+    val |= U8(mode);
 
     /* Update PMIC register */
-    (void) i2c_write(id, pmic_reg8, &val, 1U);
+    err = pf100_reg_write(id, pmic_reg8, val);
     if (err != kStatus_Success)
     {
         error_print("pmic_set_mode - Fail to set mode to %u PMIC %d, reg %u\n",
@@ -635,7 +642,7 @@ sc_err_t pf100_pmic_register_access(pmic_id_t id, uint32_t address,
 
     if (read_write == SC_FALSE)
     {
-        err = i2c_read(id, address, value, 1U);
+        err = pf100_reg_read(id, U8(address), value);
         if (err != kStatus_Success)
         {
             error_print("PMIC regr access - Fail to read PMIC at: %x, reg %x\n",
@@ -646,7 +653,16 @@ sc_err_t pf100_pmic_register_access(pmic_id_t id, uint32_t address,
     }
     else
     {
+        /* Raw write, the register may not read back as written */
         err = i2c_write(id, address, value, 1U);
+        pmic_shadow_invalidate(id, U8(address));
+
+        /* Paged registers may now show another page */
+        if (address == PAGE_REG)
+        {
+            pmic_shadow_invalidate_range(id, PAGE_START, 0xFFU);
+        }
+
         if (err != kStatus_Success)
         {
             error_print("PMIC reg access - Fail to write PMIC at: %x, reg %x\n",
@@ -660,6 +676,15 @@ sc_err_t pf100_pmic_register_access(pmic_id_t id, uint32_t address,
 
 };
 
+/*--------------------------------------------------------------------------*/
+/* Get PMIC Regulator Power Good                                            */
+/*--------------------------------------------------------------------------*/
+sc_err_t pf100_pmic_get_pg(pmic_id_t id, uint32_t pmic_reg, sc_bool_t *pg)
+{
+    /* PF100 has no per-regulator power good sense */
+    return SC_ERR_UNAVAILABLE;
+}
+
 /*--------------------------------------------------------------------------*/
 /* Service PMIC interrupt                                                   */
 /*--------------------------------------------------------------------------*/
@@ -667,6 +692,9 @@ sc_bool_t pf100_pmic_irq_service(pmic_id_t id)
 {
     uint8_t mask = 0U;
     uint8_t status = 0U;
+
+    /* PMIC may have acted on its own, drop the shadow */
+    pmic_shadow_invalidate_all(id);
     
     /* PMIC pending? */
     (void) i2c_read(id, INTSTAT0, &status, 1U);
@@ -687,3 +715,67 @@ sc_bool_t pf100_pmic_irq_service(pmic_id_t id)
     return SC_FALSE;
 }
 
+/*--------------------------------------------------------------------------*/
+/* Read a register, served from the shadow when possible                    */
+/*--------------------------------------------------------------------------*/
+static status_t pf100_reg_read(pmic_id_t id, uint8_t reg, uint8_t *val)
+{
+    status_t err = kStatus_Success;
+
+    if (reg < SHADOW_START)
+    {
+        err = i2c_read(id, reg, val, 1U);
+    }
+    else if (pmic_shadow_get(id, reg, val) == SC_FALSE)
+    {
+        err = i2c_read(id, reg, val, 1U);
+        if (err == kStatus_Success)
+        {
+            pmic_shadow_update(id, reg, *val);
+        }
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Write a register through the shadow, skipped if already current          */
+/*--------------------------------------------------------------------------*/
+static status_t pf100_reg_write(pmic_id_t id, uint8_t reg, uint8_t val)
+{
+    status_t err = kStatus_Success;
+
+    if (reg < SHADOW_START)
+    {
+        err = i2c_write(id, reg, &val, 1U);
+    }
+    else if (pmic_shadow_current(id, reg, val) == SC_FALSE)
+    {
+        err = i2c_write(id, reg, &val, 1U);
+        if (err == kStatus_Success)
+        {
+            pmic_shadow_update(id, reg, val);
+        }
+        else
+        {
+            pmic_shadow_invalidate(id, reg);
+        }
+
+        /* Paged registers may now show another page */
+        if (reg == PAGE_REG)
+        {
+            pmic_shadow_invalidate_range(id, PAGE_START, 0xFFU);
+        }
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    return err;
+}
+
@@ -237,6 +237,21 @@ uint32_t pf100_set_pmic_temp_alarm(pmic_id_t id, uint32_t temp);
 sc_err_t pf100_pmic_register_access(pmic_id_t id, uint32_t address,
     sc_bool_t read_write, uint8_t* value);
 
+/*!
+ * This function gets the power good state of a regulator. The PF100
+ * has no per-regulator sense, callers fall back to a timed wait.
+ *
+ * @param[in]     id            I2C address of PMIC device
+ * @param[in]     pmic_reg      Register corresponding to regulator
+ * @param[out]    pg            SC_TRUE if the output is within its window
+ *
+ * @return Returns an error code (SC_ERR_NONE = success)
+ *
+ * Return errors:
+ * - SC_ERR_UNAVAILABLE always
+ */
+sc_err_t pf100_pmic_get_pg(pmic_id_t id, uint32_t pmic_reg, sc_bool_t *pg);
+
 /*!
  * This function services the interrupt for the temp alarm
  *
@@ -41,9 +41,11 @@
 #ifdef PMIC_CRC /* alias the crc functions if CRC is defined */
     #define I2C_WRITE       i2c_j1850_write
     #define I2C_READ        i2c_j1850_read
+    #define I2C_READ_BURST  i2c_j1850_burst_read
 #else
     #define I2C_WRITE       i2c_write
     #define I2C_READ        i2c_read
+    #define I2C_READ_BURST  i2c_read
 #endif
 
 /*!
@@ -269,6 +271,40 @@ uint32_t pf8100_set_pmic_temp_alarm(pmic_id_t id, uint32_t temp);
 sc_err_t pf8100_pmic_register_access(pmic_id_t id, uint32_t address,
     sc_bool_t read_write, uint8_t* value);
 
+/*!
+ * This function gets the power good state of a regulator from the
+ * PF8100 under/over voltage comparators.
+ *
+ * @param[in]     id            I2C address of PMIC device
+ * @param[in]     pmic_reg      Register corresponding to regulator
+ *                              e.g [pf8100_vregs_t](@ref pf8100_vregs_t)
+ * @param[out]    pg            SC_TRUE if the output is within its window
+ *
+ * @return Returns an error code (SC_ERR_NONE = success)
+ *
+ * Return errors:
+ * - SC_ERR_PARM if invalid parameters
+ * - SC_ERR_FAIL if reading the sense registers failed
+ */
+sc_err_t pf8100_pmic_get_pg(pmic_id_t id, uint32_t pmic_reg, sc_bool_t *pg);
+
+/*!
+ * This function reads a block of consecutive registers into the
+ * register shadow, PMIC_BURST_MAX registers per bus transaction. Later
+ * reads of these registers are then served without bus traffic.
+ *
+ * @param[in]     id            I2C address of PMIC device
+ * @param[in]     reg           first register
+ * @param[in]     count         number of registers
+ *
+ * @return Returns an error code (SC_ERR_NONE = success)
+ *
+ * Return errors:
+ * - SC_ERR_PARM if the block is not in the shadowed register range
+ * - SC_ERR_FAIL if a read failed
+ */
+sc_err_t pf8100_pmic_prefetch(pmic_id_t id, uint8_t reg, uint8_t count);
+
 /*!
  * This function services the interrupt for the temp alarm
  *
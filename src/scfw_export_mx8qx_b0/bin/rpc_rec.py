@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+#
+# Copyright 2018 NXP
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""Summarize an SCFW RPC flight recorder dump.
+
+Reads the binary buffer returned by the SCFW_RPC_REC_DUMP board ioctl
+(rpc_rec_hdr_t followed by rpc_rec_t records, little endian) and prints
+per (svc, func) call counts, service time statistics and a log2 latency
+histogram in uS.
+
+Usage: rpc_rec.py [-r] dump.bin
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x43455252
+HDR = struct.Struct("<IIII")
+REC = struct.Struct("<IIHBBBBH")
+BUCKETS = 12
+
+SVC = {
+    2: "pm", 3: "rm", 5: "timer", 6: "pad", 7: "misc", 8: "irq",
+    9: "seco",
+}
+
+
+def bucket(usec):
+    """Log2 bucket: 0 = <1 uS, n = [2^(n-1), 2^n) uS, last is open."""
+    b = 0
+    while usec >= 1 and b < BUCKETS - 1:
+        usec //= 2
+        b += 1
+    return b
+
+
+def label(b):
+    if b == 0:
+        return "<1"
+    if b == BUCKETS - 1:
+        return ">=%d" % (1 << (b - 1))
+    return "<%d" % (1 << b)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-r", action="store_true",
+                        help="also list the raw records")
+    parser.add_argument("dump")
+    opts = parser.parse_args()
+
+    with open(opts.dump, "rb") as f:
+        data = f.read()
+    if len(data) < HDR.size:
+        sys.exit("%s: short dump" % opts.dump)
+    magic, seq, count, tick_hz = HDR.unpack_from(data, 0)
+    if magic != MAGIC:
+        sys.exit("%s: bad magic 0x%08x" % (opts.dump, magic))
+    if len(data) < HDR.size + count * REC.size:
+        sys.exit("%s: truncated, %d records expected" % (opts.dump, count))
+
+    recs = [REC.unpack_from(data, HDR.size + i * REC.size)
+            for i in range(count)]
+    out = sys.stdout
+    out.write("%d calls recorded, %d in dump, %d older not kept\n\n"
+              % (seq, count, seq - count))
+
+    stats = {}
+    for start, ticks, mu, svc, func, pt, err, _ in recs:
+        usec = ticks * 1000000.0 / tick_hz
+        s = stats.setdefault((svc, func),
+                             {"n": 0, "err": 0, "sum": 0.0, "max": 0.0,
+                              "min": None, "hist": [0] * BUCKETS})
+        s["n"] += 1
+        s["err"] += 1 if err else 0
+        s["sum"] += usec
+        s["max"] = max(s["max"], usec)
+        s["min"] = usec if s["min"] is None else min(s["min"], usec)
+        s["hist"][bucket(int(usec))] += 1
+        if opts.r:
+            out.write("%10u pt=%-2u mu=%-4u %-5s %3u err=%u %9.1f uS\n"
+                      % (start, pt, mu, SVC.get(svc, str(svc)), func, err,
+                         usec))
+    if opts.r:
+        out.write("\n")
+
+    out.write("%-10s %6s %5s %9s %9s %9s  %s\n"
+              % ("svc:func", "calls", "errs", "min uS", "avg uS", "max uS",
+                 " ".join("%5s" % label(b) for b in range(BUCKETS))))
+    for (svc, func), s in sorted(stats.items(),
+                                 key=lambda kv: -kv[1]["sum"]):
+        out.write("%-10s %6d %5d %9.1f %9.1f %9.1f  %s\n"
+                  % ("%s:%u" % (SVC.get(svc, str(svc)), func), s["n"],
+                     s["err"], s["min"], s["sum"] / s["n"], s["max"],
+                     " ".join("%5d" % h for h in s["hist"])))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,195 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Header file for the DDR bandwidth monitor. Samples the DRC performance
+ * counters from a board timer and keeps a rolling window per DRC. The
+ * timer only runs while a client has asked for sampling.
+ *
+ * @addtogroup BRD_SVC (BRD) Board Interface
+ *
+ * @{
+ */
+/*==========================================================================*/
+
+#ifndef SC_DDR_PERF_H
+#define SC_DDR_PERF_H
+
+/* Includes */
+
+#include "main/types.h"
+
+/* Defines */
+
+/*! Number of DRC instances */
+#ifdef SC_SUBSYS_DRC_1
+    #define DDR_PERF_NUM_DRC        2U
+#else
+    #define DDR_PERF_NUM_DRC        1U
+#endif
+
+/*! Sample period in mS */
+#ifndef DDR_PERF_PERIOD_MS
+    #define DDR_PERF_PERIOD_MS      100U
+#endif
+
+/*! Number of samples in the rolling window */
+#ifndef DDR_PERF_WINDOW
+    #define DDR_PERF_WINDOW         8U
+#endif
+
+/*! Bytes moved by one read or write command (BL16 on a x32 bus) */
+#ifndef DDR_PERF_BYTES_PER_CMD
+    #define DDR_PERF_BYTES_PER_CMD  64U
+#endif
+
+/*! Controller cycles the data bus is busy per command */
+#ifndef DDR_PERF_CYCLES_PER_CMD
+    #define DDR_PERF_CYCLES_PER_CMD 4U
+#endif
+
+/*!
+ * @name Multiplexed events
+ * The last counter moves to the next of these each sample period.
+ */
+/*@{*/
+#define DDR_PERF_MUX_ACT        0U  /*!< Activates */
+#define DDR_PERF_MUX_HP_STALL   1U  /*!< HP read requests without credit */
+#define DDR_PERF_MUX_LP_STALL   2U  /*!< LP read requests without credit */
+#define DDR_PERF_NUM_MUX        3U
+/*@}*/
+
+/* Types */
+
+/*!
+ * Counter deltas for one sample period
+ */
+typedef struct
+{
+    uint32_t usec;          /*!< Sample duration */
+    uint32_t cycles;        /*!< Controller cycles */
+    uint32_t rd_cmd;        /*!< Read commands */
+    uint32_t wr_cmd;        /*!< Write commands */
+    uint32_t mux;           /*!< Multiplexed event (DDR_PERF_MUX_*) */
+    uint32_t mux_cnt;       /*!< Count of the multiplexed event */
+} ddr_perf_sample_t;
+
+/*!
+ * Rolling window of samples with running sums
+ */
+typedef struct
+{
+    ddr_perf_sample_t sample[DDR_PERF_WINDOW];  /*!< Sample ring */
+    uint32_t usec;                              /*!< Sum of durations */
+    uint32_t cycles;                            /*!< Sum of cycles */
+    uint32_t rd_cmd;                            /*!< Sum of reads */
+    uint32_t wr_cmd;                            /*!< Sum of writes */
+    uint32_t mux_cnt[DDR_PERF_NUM_MUX];         /*!< Sums per event */
+    uint32_t mux_usec[DDR_PERF_NUM_MUX];        /*!< Time per event */
+    uint32_t mux_cycles[DDR_PERF_NUM_MUX];      /*!< Cycles per event */
+    uint32_t idx;                               /*!< Next slot to fill */
+    uint32_t num;                               /*!< Valid samples */
+} ddr_perf_window_t;
+
+/*!
+ * Bandwidth statistics returned to clients
+ */
+typedef struct
+{
+    uint32_t window_ms;     /*!< Time covered by the window */
+    uint32_t rd_kbps;       /*!< Read bandwidth in KB/s */
+    uint32_t wr_kbps;       /*!< Write bandwidth in KB/s */
+    uint32_t act_per_ms;    /*!< Activates per mS */
+    uint32_t util;          /*!< Data bus utilization in 1/1000 */
+    uint32_t hp_stall;      /*!< HP cycles without credit in 1/1000 */
+    uint32_t lp_stall;      /*!< LP cycles without credit in 1/1000 */
+} ddr_perf_stats_t;
+
+/* Functions */
+
+/*!
+ * Start or stop sampling on request of a client. Sampling is off
+ * after boot.
+ *
+ * @param[in]     enb           enable flag (SC_TRUE = on)
+ */
+void ddr_perf_enable(sc_bool_t enb);
+
+/*!
+ * Pause sampling while the DRCs are off or in retention. Sampling
+ * resumes only if a client has enabled it.
+ *
+ * @param[in]     pause         pause flag (SC_TRUE = paused)
+ */
+void ddr_perf_pause(sc_bool_t pause);
+
+/*!
+ * Get the bandwidth statistics of a DRC.
+ *
+ * @param[in]     drc           DRC instance
+ * @param[out]    stats         statistics to fill in
+ *
+ * @return Returns an error code (SC_ERR_NONE = success).
+ *
+ * Return errors:
+ * - SC_ERR_PARM if \a drc is out of range
+ */
+sc_err_t ddr_perf_get_stats(uint32_t drc, ddr_perf_stats_t *stats);
+
+/*!
+ * Add a sample to a window, replacing the oldest once full.
+ *
+ * @param[in,out] win           window to update
+ * @param[in]     sample        sample to add
+ */
+void ddr_perf_window_add(ddr_perf_window_t *win,
+    const ddr_perf_sample_t *sample);
+
+/*!
+ * Convert a window to bandwidth statistics.
+ *
+ * @param[in]     win           window to convert
+ * @param[out]    stats         statistics to fill in
+ */
+void ddr_perf_window_stats(const ddr_perf_window_t *win,
+    ddr_perf_stats_t *stats);
+
+/**@}*/
+
+#endif /* SC_DDR_PERF_H */
+
@@ -0,0 +1,419 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Implementation of the board DDR training cache.
+ */
+/*==========================================================================*/
+
+/* Includes */
+
+#include "main/main.h"
+#include "main/board.h"
+#include "drivers/common/fsl_common.h"
+#include "drivers/sysctr/fsl_sysctr.h"
+#include "board/board_common.h"
+#include "board/ddr_train.h"
+
+/* Local Defines */
+
+/* Record marker ("TRAN") */
+#define DDR_TRAIN_MAGIC     0x4E415254U
+
+/* Trained registers per PHY, the sum of ddr_train_run[] */
+#define DDR_TRAIN_WORDS     77U
+
+/* Register transfer operations */
+#define DT_READ             0U
+#define DT_WRITE            1U
+#define DT_COMPARE          2U
+
+/* Local Types */
+
+/*!
+ * Run of trained PHY registers, \a num words from word offset \a off,
+ * repeated \a rep times \a stride words apart
+ */
+typedef struct
+{
+    uint16_t off;
+    uint8_t num;
+    uint8_t rep;
+    uint16_t stride;
+} ddr_train_run_t;
+
+/*!
+ * Cache record
+ */
+typedef struct
+{
+    uint32_t magic;
+    ddr_train_key_t key;
+    uint32_t num_phy;
+    uint32_t val[DDR_TRAIN_MAX_PHY][DDR_TRAIN_WORDS];
+    uint32_t crc;
+} ddr_train_rec_t;
+
+/* Local Functions */
+
+static uint32_t ddr_train_xfer(uint32_t phy, uint32_t *buf, uint32_t op);
+static uint32_t ddr_train_crc(uint32_t crc, const void *data,
+    uint32_t size);
+static uint32_t ddr_train_rec_crc(void);
+static sc_bool_t ddr_train_key_eq(const ddr_train_key_t *a,
+    const ddr_train_key_t *b);
+static sc_bool_t ddr_train_mem_check(uint32_t addr);
+
+/* Local Variables */
+
+/* Training results: CBT, VREF, deskew, leveling, eye and gate */
+static const ddr_train_run_t ddr_train_run[] =
+{
+    {0x150U, 10U, 1U, 0x00U},   /* ACBDLR0-9 */
+    {0x161U, 1U, 1U, 0x00U},    /* ACLCDLR */
+    {0x1C5U, 2U, 4U, 0x40U},    /* DXnGCR5-6 */
+    {0x1D0U, 3U, 4U, 0x40U},    /* DXnBDLR0-2 */
+    {0x1D4U, 3U, 4U, 0x40U},    /* DXnBDLR3-5 */
+    {0x1D8U, 1U, 4U, 0x40U},    /* DXnBDLR6 */
+    {0x1E0U, 6U, 4U, 0x40U},    /* DXnLCDLR0-5 */
+    {0x1F0U, 1U, 4U, 0x40U},    /* DXnGTR0 */
+    {0x507U, 1U, 2U, 0x10U}     /* DX8SLnDQSCTL */
+};
+
+/* Kept across SCU resets that do not remove power */
+static ddr_train_rec_t ddr_train_rec __attribute__((section(".noinit")));
+
+/* DRAM words under the memory check */
+static uint32_t ddr_train_check_save[DDR_TRAIN_CHECK_WORDS];
+
+static ddr_train_stats_t ddr_train_stats;
+static uint64_t ddr_train_start = 0ULL;
+static sc_bool_t ddr_train_hit = SC_FALSE;
+
+/*--------------------------------------------------------------------------*/
+/* Restore cached training results                                          */
+/*--------------------------------------------------------------------------*/
+sc_bool_t ddr_train_restore(const ddr_train_key_t *key, uint32_t num_phy)
+{
+    sc_bool_t hit = SC_FALSE;
+    uint32_t num = MIN(num_phy, DDR_TRAIN_MAX_PHY);
+    uint32_t phy;
+
+    ddr_train_start = board_get_counter64();
+    ddr_train_hit = SC_FALSE;
+
+    if ((ddr_train_rec.magic != DDR_TRAIN_MAGIC)
+        || (ddr_train_rec.crc != ddr_train_rec_crc()))
+    {
+        ddr_train_stats.misses++;
+    }
+    else if ((ddr_train_key_eq(&ddr_train_rec.key, key) == SC_FALSE)
+        || (ddr_train_rec.num_phy != num))
+    {
+        ddr_train_stats.stale++;
+    }
+    else
+    {
+        hit = SC_TRUE;
+
+        for (phy = 0U; phy < num; phy++)
+        {
+            (void) ddr_train_xfer(phy, ddr_train_rec.val[phy], DT_WRITE);
+        }
+
+        /* Short check: every register must read back as written */
+        for (phy = 0U; phy < num; phy++)
+        {
+            if (ddr_train_xfer(phy, ddr_train_rec.val[phy], DT_COMPARE)
+                != 0U)
+            {
+                hit = SC_FALSE;
+            }
+        }
+
+        if (hit == SC_FALSE)
+        {
+            ddr_train_rec.magic = 0U;
+            ddr_train_stats.rejects++;
+        }
+    }
+
+    if (hit != SC_FALSE)
+    {
+        ddr_train_stats.hits++;
+        ddr_train_stats.restore_us = U32(SYSCTR_TICKS_TO_USEC64(
+            board_get_counter64() - ddr_train_start));
+        ddr_train_hit = SC_TRUE;
+    }
+
+    return hit;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Store training results                                                   */
+/*--------------------------------------------------------------------------*/
+void ddr_train_save(const ddr_train_key_t *key, uint32_t num_phy)
+{
+    uint32_t num = MIN(num_phy, DDR_TRAIN_MAX_PHY);
+    uint32_t phy;
+
+    /* Invalid until complete */
+    ddr_train_rec.magic = 0U;
+
+    for (phy = 0U; phy < num; phy++)
+    {
+        (void) ddr_train_xfer(phy, ddr_train_rec.val[phy], DT_READ);
+    }
+    ddr_train_rec.key = *key;
+    ddr_train_rec.num_phy = num;
+    ddr_train_rec.crc = ddr_train_rec_crc();
+    ddr_train_rec.magic = DDR_TRAIN_MAGIC;
+
+    ddr_train_stats.saves++;
+    ddr_train_stats.train_us = U32(SYSCTR_TICKS_TO_USEC64(
+        board_get_counter64() - ddr_train_start));
+}
+
+/*--------------------------------------------------------------------------*/
+/* Check DRAM after a restore                                               */
+/*--------------------------------------------------------------------------*/
+sc_err_t ddr_train_verify(uint32_t addr)
+{
+    sc_err_t err = SC_ERR_NONE;
+
+    if (ddr_train_hit != SC_FALSE)
+    {
+        uint64_t start = board_get_counter64();
+        sc_bool_t pass = ddr_train_mem_check(addr);
+
+        if (pass == SC_FALSE)
+        {
+            ddr_train_rec.magic = 0U;
+            ddr_train_stats.rejects++;
+            err = SC_ERR_FAIL;
+        }
+
+        ddr_train_stats.check_us = U32(SYSCTR_TICKS_TO_USEC64(
+            board_get_counter64() - start));
+        ddr_train_hit = SC_FALSE;
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Drop the cached record                                                   */
+/*--------------------------------------------------------------------------*/
+void ddr_train_invalidate(void)
+{
+    ddr_train_rec.magic = 0U;
+}
+
+/*--------------------------------------------------------------------------*/
+/* CRC-32 of a buffer                                                       */
+/*--------------------------------------------------------------------------*/
+uint32_t ddr_train_checksum(const void *data, uint32_t size)
+{
+    return ~ddr_train_crc(0xFFFFFFFFU, data, size);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get cache statistics                                                     */
+/*--------------------------------------------------------------------------*/
+void ddr_train_get_stats(ddr_train_stats_t *stats)
+{
+    *stats = ddr_train_stats;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Read, write or compare the trained registers of a PHY                    */
+/*--------------------------------------------------------------------------*/
+static uint32_t ddr_train_xfer(uint32_t phy, uint32_t *buf, uint32_t op)
+{
+    uint32_t diff = 0U;
+    uint32_t i = 0U;
+    uint32_t r;
+
+    for (r = 0U; r < ARRAY_SIZE(ddr_train_run); r++)
+    {
+        const ddr_train_run_t *run = &ddr_train_run[r];
+        uint32_t rep;
+        uint32_t n;
+
+        for (rep = 0U; rep < U32(run->rep); rep++)
+        {
+            for (n = 0U; n < U32(run->num); n++)
+            {
+                volatile uint32_t *reg;
+
+                {
+                    reg = (volatile uint32_t *) (DDR_PHY_BASE_ADDR(phy)
+                        + (4U * (U32(run->off) + (rep * U32(run->stride))
+                        + n)));
+                }
+
+                if (op == DT_READ)
+                {
+                    buf[i] = *reg;
+                }
+                else if (op == DT_WRITE)
+                {
+                    *reg = buf[i];
+                }
+                else
+                {
+                    if (*reg != buf[i])
+                    {
+                        diff++;
+                    }
+                }
+                i++;
+            }
+        }
+    }
+
+    return diff;
+}
+
+/*--------------------------------------------------------------------------*/
+/* CRC-32 (IEEE), 4 bits at a time                                          */
+/*--------------------------------------------------------------------------*/
+static uint32_t ddr_train_crc(uint32_t crc, const void *data,
+    uint32_t size)
+{
+    static const uint32_t tab[16] =
+    {
+        0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+        0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+        0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+        0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+    };
+    const uint8_t *buf = (const uint8_t *) data;
+    uint32_t i;
+
+    for (i = 0U; i < size; i++)
+    {
+        crc = (crc >> 4U) ^ tab[(crc ^ U32(buf[i])) & 0xFU];
+        crc = (crc >> 4U) ^ tab[(crc ^ (U32(buf[i]) >> 4U)) & 0xFU];
+    }
+
+    return crc;
+}
+
+/*--------------------------------------------------------------------------*/
+/* CRC of the record key and values                                         */
+/*--------------------------------------------------------------------------*/
+static uint32_t ddr_train_rec_crc(void)
+{
+    uint32_t hdr[5];
+    uint32_t crc;
+
+    hdr[0] = ddr_train_rec.key.dcd;
+    hdr[1] = ddr_train_rec.key.rate;
+    hdr[2] = ddr_train_rec.key.band;
+    hdr[3] = ddr_train_rec.key.board;
+    hdr[4] = ddr_train_rec.num_phy;
+
+    crc = ddr_train_crc(0xFFFFFFFFU, hdr, U32(sizeof(hdr)));
+    if (ddr_train_rec.num_phy <= DDR_TRAIN_MAX_PHY)
+    {
+        crc = ddr_train_crc(crc, ddr_train_rec.val,
+            ddr_train_rec.num_phy * DDR_TRAIN_WORDS * 4U);
+    }
+
+    return ~crc;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Compare keys                                                             */
+/*--------------------------------------------------------------------------*/
+static sc_bool_t ddr_train_key_eq(const ddr_train_key_t *a,
+    const ddr_train_key_t *b)
+{
+    return ((a->dcd == b->dcd) && (a->rate == b->rate)
+        && (a->band == b->band) && (a->board == b->board))
+        ? SC_TRUE : SC_FALSE;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Write and read back an address and bit pattern                           */
+/*--------------------------------------------------------------------------*/
+static sc_bool_t ddr_train_mem_check(uint32_t addr)
+{
+    sc_bool_t pass = SC_TRUE;
+    uint32_t inv;
+    uint32_t i;
+
+    /* A warm reset leaves DRAM powered, keep what is there */
+    for (i = 0U; i < DDR_TRAIN_CHECK_WORDS; i++)
+    {
+        ddr_train_check_save[i] = *((volatile const uint32_t *)
+            (addr + (i * DDR_TRAIN_CHECK_STRIDE)));
+    }
+
+    /* Address in data, then inverted so every bit toggles */
+    for (inv = 0U; inv < 2U; inv++)
+    {
+        uint32_t flip = (inv == 0U) ? 0x5A5A5A5AU : 0xA5A5A5A5U;
+
+        for (i = 0U; i < DDR_TRAIN_CHECK_WORDS; i++)
+        {
+            uint32_t a = addr + (i * DDR_TRAIN_CHECK_STRIDE);
+
+            *((volatile uint32_t *) a) = a ^ flip;
+        }
+        for (i = 0U; i < DDR_TRAIN_CHECK_WORDS; i++)
+        {
+            uint32_t a = addr + (i * DDR_TRAIN_CHECK_STRIDE);
+
+            if (*((volatile uint32_t *) a) != (a ^ flip))
+            {
+                pass = SC_FALSE;
+            }
+        }
+    }
+
+    for (i = 0U; i < DDR_TRAIN_CHECK_WORDS; i++)
+    {
+        *((volatile uint32_t *) (addr + (i * DDR_TRAIN_CHECK_STRIDE)))
+            = ddr_train_check_save[i];
+    }
+
+    return pass;
+}
+
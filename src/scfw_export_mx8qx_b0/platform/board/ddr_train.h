@@ -0,0 +1,181 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Header file for the board DDR training cache. After a full DDR
+ * training the trained PHY delay, deskew and VREF registers are stored
+ * with a key (DCD checksum, DRC rate, temperature band and board ID) in
+ * RAM that is not cleared by the startup code. A later cold init with
+ * the same key writes them back instead of running the training steps
+ * of the DCD, then checks the result. Any mismatch falls back to full
+ * training.
+ *
+ * @addtogroup BRD_SVC (BRD) Board Interface
+ *
+ * @{
+ */
+/*==========================================================================*/
+
+#ifndef SC_DDR_TRAIN_H
+#define SC_DDR_TRAIN_H
+
+/* Includes */
+
+#include "main/types.h"
+
+/* Defines */
+
+/*!
+ * Number of DDR PHYs held in the cache
+ */
+#ifndef DDR_TRAIN_MAX_PHY
+    #define DDR_TRAIN_MAX_PHY       2U
+#endif
+
+/*!
+ * Width of a temperature band in degrees C
+ */
+#ifndef DDR_TRAIN_TEMP_BAND
+    #define DDR_TRAIN_TEMP_BAND     25U
+#endif
+
+/*!
+ * @name Memory check
+ * Words written and read back by ddr_train_verify() and the distance
+ * between them in bytes.
+ */
+/*@{*/
+#ifndef DDR_TRAIN_CHECK_WORDS
+    #define DDR_TRAIN_CHECK_WORDS   256U
+#endif
+#define DDR_TRAIN_CHECK_STRIDE      0x1040U
+/*@}*/
+
+/* Types */
+
+/*!
+ * Cache key. Cached results are only used when all fields match.
+ */
+typedef struct
+{
+    uint32_t dcd;           /*!< DCD checksum */
+    uint32_t rate;          /*!< DRC clock rate in Hz */
+    uint32_t band;          /*!< Temperature band */
+    uint32_t board;         /*!< Board ID */
+} ddr_train_key_t;
+
+/*!
+ * Cache statistics for this boot
+ */
+typedef struct
+{
+    uint32_t hits;          /*!< Restores that replaced training */
+    uint32_t misses;        /*!< No valid record */
+    uint32_t stale;         /*!< Valid record with a different key */
+    uint32_t rejects;       /*!< Restores failed by a check */
+    uint32_t saves;         /*!< Records written after training */
+    uint32_t train_us;      /*!< Time of the last training */
+    uint32_t restore_us;    /*!< Time of the last restore */
+    uint32_t check_us;      /*!< Time of the last memory check */
+} ddr_train_stats_t;
+
+/* Functions */
+
+/*!
+ * Restore cached training results. Called from the DCD in place of
+ * the training steps, with VT compensation inhibited and the PUB in
+ * control of the DRAM. The registers are read back after the write.
+ *
+ * @param[in]     key           key for the current conditions
+ * @param[in]     num_phy       number of PHYs to restore
+ *
+ * @return Returns SC_TRUE if the results were restored. SC_FALSE if
+ *         the caller must train.
+ */
+sc_bool_t ddr_train_restore(const ddr_train_key_t *key, uint32_t num_phy);
+
+/*!
+ * Store the results of a full training. Called from the DCD right
+ * after the last training step.
+ *
+ * @param[in]     key           key for the current conditions
+ * @param[in]     num_phy       number of PHYs to store
+ */
+void ddr_train_save(const ddr_train_key_t *key, uint32_t num_phy);
+
+/*!
+ * Check DRAM after a restore once the controller is running. Does
+ * nothing if this boot trained. On failure the record is dropped so
+ * the next cold init trains.
+ *
+ * The check words are saved first and written back after the check,
+ * so DRAM contents kept over a warm reset survive. The area spans
+ * DDR_TRAIN_CHECK_WORDS * DDR_TRAIN_CHECK_STRIDE bytes.
+ *
+ * @param[in]     addr          DRAM address of the check area
+ *
+ * @return Returns SC_ERR_FAIL if a restore failed the check.
+ */
+sc_err_t ddr_train_verify(uint32_t addr);
+
+/*!
+ * Drop the cached record. The next cold init trains.
+ */
+void ddr_train_invalidate(void);
+
+/*!
+ * CRC-32 of a buffer, for a DCD checksum computed at run time.
+ *
+ * @param[in]     data          buffer
+ * @param[in]     size          size in bytes
+ *
+ * @return Returns the CRC.
+ */
+uint32_t ddr_train_checksum(const void *data, uint32_t size);
+
+/*!
+ * Get the cache statistics.
+ *
+ * @param[out]    stats         statistics to fill in
+ */
+void ddr_train_get_stats(ddr_train_stats_t *stats);
+
+/**@}*/
+
+#endif /* SC_DDR_TRAIN_H */
+
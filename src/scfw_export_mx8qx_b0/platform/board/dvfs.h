@@ -0,0 +1,224 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Header file for the board DVFS governor. Picks CPU/GPU operating
+ * points from load hints pushed by the owning partition.
+ *
+ * A board timer samples elapsed time every period. Decisions and the
+ * clock/voltage changes run after the next RPC is dispatched, so an
+ * idle system stays at its current OPP until a partition calls in.
+ *
+ * @addtogroup BRD_SVC (BRD) Board Interface
+ *
+ * @{
+ */
+/*==========================================================================*/
+
+#ifndef SC_DVFS_H
+#define SC_DVFS_H
+
+/* Includes */
+
+#include "main/types.h"
+#include "svc/pm/api.h"
+#include "svc/rm/api.h"
+
+/* Defines */
+
+/*! Max number of OPPs per domain */
+#define DVFS_MAX_OPP            6U
+
+/*! Governor period in mS */
+#ifndef DVFS_PERIOD_MS
+    #define DVFS_PERIOD_MS      20U
+#endif
+
+/*! Target load in % of an OPP when picking one */
+#ifndef DVFS_UP_PCT
+    #define DVFS_UP_PCT         80U
+#endif
+
+/*! Periods demand must stay lower before stepping down */
+#ifndef DVFS_DOWN_HOLD
+    #define DVFS_DOWN_HOLD      5U
+#endif
+
+/*! Minimum time between voltage changes in mS */
+#ifndef DVFS_MIN_RAMP_MS
+    #define DVFS_MIN_RAMP_MS    100U
+#endif
+
+/* Types */
+
+/*!
+ * Operating point
+ */
+typedef struct
+{
+    uint32_t freq;          /*!< Clock rate in Hz */
+    uint32_t volt;          /*!< Voltage the SoC code sets for it in uV */
+} dvfs_opp_t;
+
+/*!
+ * Statistics of one domain returned to clients
+ */
+typedef struct
+{
+    uint32_t num_opp;                   /*!< Number of OPPs */
+    uint32_t cur;                       /*!< Current OPP */
+    uint32_t transitions;               /*!< OPP changes */
+    uint32_t ramps;                     /*!< OPP changes with a new voltage */
+    uint32_t time_ms[DVFS_MAX_OPP];     /*!< Time at each OPP */
+} dvfs_stats_t;
+
+/*!
+ * Governed clock domain. The board provides the resource, clock and
+ * OPP table (ascending frequency), the rest is governor state.
+ */
+typedef struct
+{
+    sc_rsrc_t rsrc;             /*!< Resource whose clock is scaled */
+    sc_pm_clk_t clk;            /*!< Clock to scale */
+    const dvfs_opp_t *opp;      /*!< OPP table */
+    uint8_t num_opp;            /*!< Number of OPPs */
+    sc_bool_t enabled;          /*!< Governor on */
+    uint8_t cur;                /*!< Current OPP */
+    uint8_t floor;              /*!< Lowest OPP allowed */
+    uint8_t load;               /*!< Last load hint in % of cur */
+    uint8_t low;                /*!< Periods demand was below cur */
+    uint64_t last_ramp;         /*!< Time of the last voltage change */
+    dvfs_stats_t stats;         /*!< Statistics */
+} dvfs_domain_t;
+
+/* Functions */
+
+/*!
+ * Register the governed domains. Called once by the board.
+ *
+ * @param[in]     dom           array of domains
+ * @param[in]     num           number of domains
+ */
+void dvfs_init(dvfs_domain_t *dom, uint32_t num);
+
+/*!
+ * Enable or disable the governor for a resource. While disabled the
+ * clock is left where the governor or the partition last set it.
+ *
+ * @param[in]     caller_pt     handle of caller partition
+ * @param[in]     rsrc          governed resource
+ * @param[in]     enb           enable flag (SC_TRUE = on)
+ *
+ * @return Returns an error code (SC_ERR_NONE = success).
+ *
+ * Return errors:
+ * - SC_ERR_PARM if \a rsrc is not governed,
+ * - SC_ERR_NOACCESS if the caller does not own \a rsrc
+ */
+sc_err_t dvfs_enable(sc_rm_pt_t caller_pt, sc_rsrc_t rsrc, sc_bool_t enb);
+
+/*!
+ * Set the performance floor of a resource.
+ *
+ * @param[in]     caller_pt     handle of caller partition
+ * @param[in]     rsrc          governed resource
+ * @param[in]     freq          lowest rate allowed in Hz (0 = none)
+ *
+ * The floor is the lowest OPP at or above \a freq.
+ *
+ * @return Returns an error code (SC_ERR_NONE = success).
+ *
+ * Return errors:
+ * - SC_ERR_PARM if \a rsrc is not governed or \a freq is above all OPPs,
+ * - SC_ERR_NOACCESS if the caller does not own \a rsrc
+ */
+sc_err_t dvfs_set_floor(sc_rm_pt_t caller_pt, sc_rsrc_t rsrc,
+    uint32_t freq);
+
+/*!
+ * Push a load hint for a resource.
+ *
+ * @param[in]     caller_pt     handle of caller partition
+ * @param[in]     rsrc          governed resource
+ * @param[in]     load          busy time at the current rate in %
+ *
+ * @return Returns an error code (SC_ERR_NONE = success).
+ *
+ * Return errors:
+ * - SC_ERR_PARM if \a rsrc is not governed or \a load is over 100,
+ * - SC_ERR_NOACCESS if the caller does not own \a rsrc
+ */
+sc_err_t dvfs_hint(sc_rm_pt_t caller_pt, sc_rsrc_t rsrc, uint32_t load);
+
+/*!
+ * Get the statistics of a resource.
+ *
+ * @param[in]     rsrc          governed resource
+ * @param[out]    stats         statistics to fill in
+ *
+ * @return Returns an error code (SC_ERR_NONE = success).
+ *
+ * Return errors:
+ * - SC_ERR_PARM if \a rsrc is not governed
+ */
+sc_err_t dvfs_get_stats(sc_rsrc_t rsrc, dvfs_stats_t *stats);
+
+/*!
+ * Pick the next OPP of a domain. Pure policy, touches no hardware.
+ *
+ * @param[in]     dom           domain
+ * @param[in]     now           current time in SYSCTR ticks
+ * @param[out]    need          lowest OPP serving the demand
+ *
+ * Demand is the load hint scaled to the current rate. Going up, the
+ * governor jumps straight to the highest OPP sharing the voltage of
+ * the first OPP that serves the demand at DVFS_UP_PCT, so further load
+ * growth costs no ramp. Going down waits DVFS_DOWN_HOLD periods.
+ * Voltage changes are at most one per DVFS_MIN_RAMP_MS, otherwise
+ * only OPPs at the current voltage are reachable.
+ *
+ * @return Returns the OPP index to run at.
+ */
+uint8_t dvfs_select(const dvfs_domain_t *dom, uint64_t now,
+    uint8_t *need);
+
+/**@}*/
+
+#endif /* SC_DVFS_H */
+
@@ -60,6 +60,7 @@
 #include "all_svc.h"
 #include "drivers/lpi2c/fsl_lpi2c.h"
 #include "drivers/pmic/fsl_pmic.h"
+#include "drivers/pmic/fsl_i2c_queue.h"
 #include "drivers/pmic/pf8100/fsl_pf8100.h"
 #include "drivers/gpio/fsl_gpio.h"
 #include "drivers/igpio/fsl_igpio.h"
@@ -71,9 +72,18 @@
 #include "pads.h"
 #include "drivers/pad/fsl_pad.h"
 #include "dcd/dcd_retention.h"
+#include "board/ddr_perf.h"
+#include "board/dvfs.h"
+#include "board/rpc_rec.h"
+#include "board/rm_index.h"
+#include "board/xrdc_shadow.h"
+#include "board/ddr_train.h"
+#include "board/ddr_ret.h"
 #include "drivers/systick/fsl_systick.h"
+#include "drivers/sysctr/fsl_sysctr.h"
 
 #include "eeprom.h"
+#include "board_ioctl.h"
 #include "ddr_table.h"
 
 /* Local Defines */
@@ -139,21 +149,122 @@
     #define DEBUG_BAUD          115200U
 #endif
 
+/*!
+ * DRAM checked after restoring cached training results. The check runs
+ * from board_init_ddr() before the ROM loads the boot images, so no
+ * image is in DRAM yet. Anything else kept over a warm reset (e.g. a
+ * crash log) is saved and written back by the check.
+ */
+#define BRD_DDR_TRAIN_CHECK     0x80000000U
+
+/*!
+ * @name PMIC thermal sense register
+ * Read for the DDR training key before the PMIC is set up.
+ */
+/*@{*/
+#define BRD_PF8100_THERMSENSE   0x09U
+#define BRD_PF8100_THERM_MASK   0x3FU
+/*@}*/
+
+/*!
+ * @name DDR retention runs
+ * A DCD .cfg may set BD_DDR_RET_REGIONn_STRIDE and BD_DDR_RET_REGIONn_MASK
+ * to leave out words of a region that retraining does not overwrite.
+ * The buffer still holds the whole regions so the SoC retention code
+ * can copy them if the runs cannot be set up. While the runs are in
+ * use the SoC code gets the regions copied in place, a no-op.
+ */
+/*@{*/
+#define BRD_DDR_RET_RUN(N)      {BD_DDR_RET_REGION##N##_ADDR, \
+                                BD_DDR_RET_REGION##N##_SIZE, \
+                                BD_DDR_RET_REGION##N##_STRIDE, \
+                                BD_DDR_RET_REGION##N##_MASK}
+#define BRD_DDR_RET_REGION(N)   {BD_DDR_RET_REGION##N##_ADDR, \
+                                BD_DDR_RET_REGION##N##_SIZE, \
+                                (uint32_t *) BD_DDR_RET_REGION##N##_ADDR}
+#define BRD_DDR_RET_SOC(N)      {BD_DDR_RET_REGION##N##_ADDR, \
+                                BD_DDR_RET_REGION##N##_SIZE, \
+                                &board_ddr_ret_buf[BRD_DDR_RET_OFS##N]}
+#define BRD_DDR_RET_OFS1        0U
+#define BRD_DDR_RET_OFS2        (BRD_DDR_RET_OFS1 + BD_DDR_RET_REGION1_SIZE)
+#define BRD_DDR_RET_OFS3        (BRD_DDR_RET_OFS2 + BD_DDR_RET_REGION2_SIZE)
+#ifndef BD_DDR_RET_REGION1_STRIDE
+    #define BD_DDR_RET_REGION1_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION1_MASK
+    #define BD_DDR_RET_REGION1_MASK     DDR_RET_MASK_ALL
+#endif
+#ifndef BD_DDR_RET_REGION2_STRIDE
+    #define BD_DDR_RET_REGION2_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION2_MASK
+    #define BD_DDR_RET_REGION2_MASK     DDR_RET_MASK_ALL
+#endif
+#ifndef BD_DDR_RET_REGION3_STRIDE
+    #define BD_DDR_RET_REGION3_STRIDE   0U
+#endif
+#ifndef BD_DDR_RET_REGION3_MASK
+    #define BD_DDR_RET_REGION3_MASK     DDR_RET_MASK_ALL
+#endif
+/*@}*/
+
 /* Local Types */
 
 /* Local Functions */
 
 static void pmic_init(void);
+#ifndef EMUL
+    static void pmic_i2c_init(void);
+#endif
 static sc_err_t pmic_ignore_current_limit(uint8_t address,
     pmic_version_t ver);
 static sc_err_t pmic_update_timing(uint8_t address);
 static void board_get_pmic_info(sc_sub_t ss, uint32_t *pmic_reg,
     uint8_t *num_regs);
+static void board_ramp_done(pmic_id_t id, uint32_t pmic_reg,
+    sc_err_t err);
+static void pmic_irq_work(void);
+static void board_ddr_train_get_key(ddr_train_key_t *key);
+
+/* Handlers (replace the weak defaults in the vector table) */
+
+void LPI2C0_IRQHandler(void);
 
 /* Local Variables */
 
 static pmic_version_t pmic_ver;
 static uint32_t temp_alarm;
+static board_irq_defer_t pmic_irq;
+
+/*! Key of the DDR training cache for this boot, used by the DCD */
+static ddr_train_key_t board_ddr_train_key;
+
+/*!
+ * DVFS operating points, voltages as programmed by the SoC code.
+ */
+/*@{*/
+static const dvfs_opp_t dvfs_a35_opp[] =
+{
+    {600000000U, 1000000U}, {900000000U, 1000000U},
+    {1200000000U, 1100000U}
+};
+static const dvfs_opp_t dvfs_gpu_opp[] =
+{
+    {372000000U, 1000000U}, {650000000U, 1000000U},
+    {700000000U, 1100000U}
+};
+/*@}*/
+
+/*! DVFS governed domains */
+static dvfs_domain_t dvfs_domain[] =
+{
+    {SC_R_A35, SC_PM_CLK_CPU, dvfs_a35_opp, U8(ARRAY_SIZE(dvfs_a35_opp))},
+    {SC_R_GPU_0_PID0, SC_PM_CLK_PER, dvfs_gpu_opp,
+        U8(ARRAY_SIZE(dvfs_gpu_opp))}
+};
+
+/*! Boot partition, its parents may change system wide settings */
+static sc_rm_pt_t board_pt_boot = SC_PT;
 
 /*!
  * This constant contains info to map resources to the board.
@@ -218,6 +329,12 @@ void board_init(boot_phase_t phase)
 {
     ss_print(3, "board_init(%d)\n", phase);
 
+    /* No HW access (SYSCTR) in the API phase */
+    if (phase != BOOT_PHASE_API_INIT)
+    {
+        board_boot_mark(BOARD_BOOT_INIT, U32(phase));
+    }
+
     if (phase == BOOT_PHASE_FINAL_INIT)
     {
         /* Configure SNVS button for rising edge */
@@ -225,6 +342,9 @@ void board_init(boot_phase_t phase)
 
         /* Init PMIC if not already done */
         pmic_init();
+
+        /* Register DVFS domains, governed once enabled by the owner */
+        dvfs_init(dvfs_domain, U32(ARRAY_SIZE(dvfs_domain)));
     }
     else if (phase == BOOT_PHASE_EARLY_INIT)
     {
@@ -495,36 +615,63 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
         /* Storage for DRC PHY registers */
         static ddr_phy board_ddr_ret_drc_phy_inst[BD_DDR_RET_NUM_DRC];
         
-        /* Storage for DDR regions */
-        static uint32_t board_ddr_ret_buf1[BD_DDR_RET_REGION1_SIZE];
+        /* Storage for the DDR regions */
+        static uint32_t board_ddr_ret_buf[BD_DDR_RET_WORDS];
+        
+        /* DDR region runs, restored in this order */
+        static const ddr_ret_run_t board_ddr_ret_run[BD_DDR_RET_NUM_REGION] = 
+        {
+            BRD_DDR_RET_RUN(1),
         #ifdef BD_DDR_RET_REGION2_SIZE
-        static uint32_t board_ddr_ret_buf2[BD_DDR_RET_REGION2_SIZE];
+            BRD_DDR_RET_RUN(2),
         #endif
         #ifdef BD_DDR_RET_REGION3_SIZE
-        static uint32_t board_ddr_ret_buf3[BD_DDR_RET_REGION3_SIZE];
+            BRD_DDR_RET_RUN(3)
         #endif
-        
-        /* DDR region descriptors */
+        };
+
+        /* DDR region descriptors copied in place, backstop for the runs */
         static const soc_ddr_ret_region_t board_ddr_ret_region[BD_DDR_RET_NUM_REGION] = 
         {
-            { BD_DDR_RET_REGION1_ADDR, BD_DDR_RET_REGION1_SIZE, board_ddr_ret_buf1 },
+            BRD_DDR_RET_REGION(1),
         #ifdef BD_DDR_RET_REGION2_SIZE
-            { BD_DDR_RET_REGION2_ADDR, BD_DDR_RET_REGION2_SIZE, board_ddr_ret_buf2 },
+            BRD_DDR_RET_REGION(2),
         #endif
         #ifdef BD_DDR_RET_REGION3_SIZE
-            { BD_DDR_RET_REGION3_ADDR, BD_DDR_RET_REGION3_SIZE, board_ddr_ret_buf3 }
+            BRD_DDR_RET_REGION(3)
         #endif
         };
 
-        /* DDR retention descriptor passed to SCFW */
+        /* DDR region descriptors, used if the runs are rejected */
+        static const soc_ddr_ret_region_t board_ddr_ret_region_soc[BD_DDR_RET_NUM_REGION] = 
+        {
+            BRD_DDR_RET_SOC(1),
+        #ifdef BD_DDR_RET_REGION2_SIZE
+            BRD_DDR_RET_SOC(2),
+        #endif
+        #ifdef BD_DDR_RET_REGION3_SIZE
+            BRD_DDR_RET_SOC(3)
+        #endif
+        };
+
+        /* DDR retention descriptor passed to SCFW, the regions are
+           copied by the board retention engine */
         static soc_ddr_ret_info_t board_ddr_ret_info = 
         { 
           BD_DDR_RET_NUM_DRC, board_ddr_ret_drc_inst, board_ddr_ret_drc_phy_inst, 
           BD_DDR_RET_NUM_REGION, board_ddr_ret_region
         };
+
+        /* DDR retention descriptor with the regions copied by SCFW */
+        static soc_ddr_ret_info_t board_ddr_ret_info_soc = 
+        { 
+          BD_DDR_RET_NUM_DRC, board_ddr_ret_drc_inst, board_ddr_ret_drc_phy_inst, 
+          BD_DDR_RET_NUM_REGION, board_ddr_ret_region_soc
+        };
     #endif
 
     board_print(3, "board_init_ddr(%d)\n", early);
+    board_boot_mark(BOARD_BOOT_DDR, U32(early));
 
     #ifdef SKIP_DDR
         return SC_ERR_UNAVAILABLE;
@@ -536,11 +683,23 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
 
         if ((err == SC_ERR_NONE) && (ddr_initialized == SC_FALSE))
         {
+            board_ddr_train_get_key(&board_ddr_train_key);
+
             board_print(1, "SCFW: ");
             err = board_ddr_config(SC_FALSE, BOARD_DDR_COLD_INIT);
             #ifdef LP4_MANUAL_DERATE_WORKAROUND
                 ddrc_lpddr4_derate_init(BD_DDR_RET_NUM_DRC);
             #endif
+
+            /* Restored training results must pass a DRAM check, else
+               drop them and reset to train */
+            if ((err == SC_ERR_NONE)
+                && (ddr_train_verify(BRD_DDR_TRAIN_CHECK) != SC_ERR_NONE))
+            {
+                error_print("DDR training cache check failed\n");
+                (void) board_reset(SC_PM_RESET_TYPE_COLD,
+                    SC_PM_RESET_REASON_SCFW_FAULT, SC_PT);
+            }
         }
 
         #ifdef DEBUG_BOARD
@@ -556,7 +715,16 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
         if (err == SC_ERR_NONE)
         {
             #ifdef BD_DDR_RET
-                soc_ddr_config_retention(&board_ddr_ret_info);
+                if (ddr_ret_init(board_ddr_ret_run, BD_DDR_RET_NUM_REGION,
+                    board_ddr_ret_buf, BD_DDR_RET_WORDS) != SC_ERR_NONE)
+                {
+                    error_print("DDR retention runs rejected\n");
+                    soc_ddr_config_retention(&board_ddr_ret_info_soc);
+                }
+                else
+                {
+                    soc_ddr_config_retention(&board_ddr_ret_info);
+                }
             #endif
 
             #ifdef BD_LPDDR4_INC_DQS2DQ
@@ -570,6 +738,8 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
             board_ddr_derate_periodic_enable(SC_TRUE);
         #endif
 
+        board_boot_mark(BOARD_BOOT_DDR_DONE, U32(err));
+
         return err;
     #endif
 }
@@ -578,25 +748,100 @@ sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initialized)
 /* Take action on DDR                                                       */
 /*--------------------------------------------------------------------------*/
 
+/* Rows of dcd_table[] ordered by (reg, cmd, position) */
+static uint16_t dcd_index[DCD_INDEX_MAX];
+
+/* Staging buffer for the adjustment table region of the EEPROM */
+static uint8_t adj_table_buf[EEPROM_SIZE];
+
+static int dcd_row_cmp(const struct dram_cfg_param *a,
+		       const struct dram_cfg_param *b)
+{
+	if (a->reg != b->reg)
+		return (a->reg < b->reg) ? -1 : 1;
+	if (a->cmd != b->cmd)
+		return (a->cmd < b->cmd) ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Build the register address index over the DCD table
+ *
+ * The sort is stable, so rows sharing a (reg, cmd) key stay in
+ * table order. The DCD table is mostly grouped by address, which
+ * keeps the insertion sort close to linear.
+ */
+static void dcd_index_build(struct dram_cfg_param *table, int table_size)
+{
+	int i, k;
+	uint16_t row;
+
+	for (i = 0; i < table_size; i++) {
+		row = (uint16_t)i;
+		for (k = i; (k > 0) &&
+		     (dcd_row_cmp(&table[dcd_index[k - 1]], &table[row]) > 0); k--)
+			dcd_index[k] = dcd_index[k - 1];
+		dcd_index[k] = row;
+	}
+}
+
+/*
+ * Find the first DCD row at or after @from matching @adj
+ *
+ * Returns the row number, or -1 if there is none.
+ */
+static int dcd_index_find(struct dram_cfg_param *table, int table_size,
+			  const struct dram_cfg_param *adj, int from)
+{
+	int lo = 0, hi = table_size;
+	int mid;
+
+	/* Lower bound of the (reg, cmd) key */
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (dcd_row_cmp(&table[dcd_index[mid]], adj) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	/* Duplicate keys are in table order */
+	for (; (lo < table_size) &&
+	       (dcd_row_cmp(&table[dcd_index[lo]], adj) == 0); lo++) {
+		if (dcd_index[lo] >= from)
+			return dcd_index[lo];
+	}
+
+	return -1;
+}
+
 /*
  * Modify DCD table based on the adjustment table in EEPROM
  *
  * Assumption: register addresses in the adjustment table
  * follow the order of register addresses in the original table
  *
- * @adj_table_offset - offset of adjustment table from start of EEPROM
- * @adj_table_size   - number of rows in adjustment table
+ * The adjustment table region is fetched with sequential reads into
+ * adj_table_buf[] and each row is looked up through dcd_index[], so
+ * the merge costs one binary search per adjustment row.
+ *
  * @table            - pointer to DDR table
  * @table_size       - number of rows in DDR table
  */
 static void adjust_dcd_table(struct dram_cfg_param *table, int table_size)
 {
 	int i, j = 0;
-	int off;
+	int row;
 	int adj_table_size;
+	uint32_t adj_table_bytes;
 	status_t err;
 	struct var_eeprom e;
-	struct dram_cfg_param adj_table_row;
+	const struct dram_cfg_param *adj;
+	sc_bool_t indexed = SC_FALSE;
+#if defined(DEBUG) && defined(DEBUG_BOARD)
+	uint32_t start = SYSCTR_GetUsec32();
+	struct eeprom_stats stats;
+#endif
 
 	/* Initialize EEPROM I2C bus */
 	eeprom_i2c_init();
@@ -618,44 +863,139 @@ static void adjust_dcd_table(struct dram_cfg_param *table, int table_size)
 		return;
 	}
 
+	/* Check the table bounds before trusting them */
+	if (e.off[1] < e.off[0]) {
+		board_print(3, "Invalid DRAM table offsets %d, %d\n",
+			e.off[0], e.off[1]);
+		return;
+	}
+
 	/* Calculate DRAM adjustment table size */
 	adj_table_size = (e.off[1] - e.off[0]) / (sizeof(struct dram_cfg_param));
+	adj_table_bytes = adj_table_size * sizeof(struct dram_cfg_param);
 	board_print(3, "Adjustment table size is %d\n", adj_table_size);
 
+	/* Fetch the whole adjustment table */
+	err = eeprom_i2c_read_bulk(EEPROM_I2C_ADDRESS, e.off[0],
+				   adj_table_buf, adj_table_bytes);
+	if (err != I32(kStatus_Success)) {
+		board_print(3, "EEPROM table read failed, err=%d\n", err);
+		return;
+	}
+
+	/* Index the DCD table, fall back to scanning if it is too large */
+	if (table_size <= DCD_INDEX_MAX) {
+		dcd_index_build(table, table_size);
+		indexed = SC_TRUE;
+	}
+
 	/* Iterate over the adjustment table */
-	off = e.off[0];
 	for (i = 0; i < adj_table_size; i++) {
 
-		/* Read next entry from the adjustment table */
-		eeprom_i2c_read(EEPROM_I2C_ADDRESS, off,
-				(uint8_t *)&adj_table_row, sizeof(adj_table_row));
-
-		/* Iterate over the DCD table and adjust it */
-		for (; j < table_size; j++) {
-			if ((table[j].cmd == adj_table_row.cmd) &&
-			    (table[j].reg == adj_table_row.reg)) {
-				board_print(3, "Adjusting: cmd=0x%x reg=0x%x val=0x%x\n",
-					adj_table_row.cmd, adj_table_row.reg, adj_table_row.val);
-				table[j].val = adj_table_row.val;
-				break;
+		/* Next entry, the packed row type tolerates misalignment */
+		adj = (const struct dram_cfg_param *)
+			&adj_table_buf[i * sizeof(struct dram_cfg_param)];
+
+		/* Find the DCD row and adjust it */
+		if (indexed == SC_TRUE) {
+			row = dcd_index_find(table, table_size, adj, j);
+		} else {
+			for (row = j; row < table_size; row++) {
+				if (dcd_row_cmp(&table[row], adj) == 0)
+					break;
 			}
 		}
 
-		off += sizeof(adj_table_row);
+		if ((row < 0) || (row >= table_size)) {
+			/* Rows are ordered, nothing further can match */
+			board_print(3, "No match: cmd=0x%x reg=0x%x\n",
+				adj->cmd, adj->reg);
+			j = table_size;
+			continue;
+		}
+
+		board_print(3, "Adjusting: cmd=0x%x reg=0x%x val=0x%x\n",
+			adj->cmd, adj->reg, adj->val);
+		table[row].val = adj->val;
+		j = row;
 	}
 
 	board_print(3, "Done adjusting DCD table\n");
+#if defined(DEBUG) && defined(DEBUG_BOARD)
+	eeprom_get_stats(&stats);
+	board_print(2, "DCD adjust: %u bytes, %u transactions, %u us I2C, %u us total\n",
+		stats.bytes, stats.transactions, stats.usec,
+		SYSCTR_GetUsec32() - start);
+#endif
+}
+
+/*
+ * Find the DCD rows of the PHY training steps, from the first PIR write
+ * launching a training step to the status checks after the last one.
+ *
+ * @table            - pointer to DDR table
+ * @table_size       - number of rows in DDR table
+ * @first            - returns first row of the training steps
+ * @last             - returns last row of the training steps
+ *
+ * Returns SC_FALSE if the table has no training steps.
+ */
+static sc_bool_t dcd_train_span(const struct dram_cfg_param *table,
+	int table_size, int *first, int *last)
+{
+	int i;
+
+	*first = -1;
+	*last = -1;
+
+	for (i = 0; i < table_size; i++) {
+		if ((table[i].cmd == DCD_WRITE)
+		    && (table[i].reg == DDR_PHY_PIR_0)
+		    && ((table[i].val & DCD_PIR_TRAIN) != 0U)) {
+			if (*first < 0)
+				*first = i;
+			*last = i;
+		}
+	}
+
+	if (*first < 0)
+		return SC_FALSE;
+
+	/* Include the checks waiting for the last step to complete */
+	while ((*last + 1 < table_size)
+	       && (table[*last + 1].reg == DDR_PHY_PGSR0_0)
+	       && ((table[*last + 1].cmd == DCD_CHECK_BITS_SET)
+		   || (table[*last + 1].cmd == DCD_CHECK_BITS_CLR)))
+		(*last)++;
+
+	return SC_TRUE;
 }
 
 static void board_dcd_config(void)
 {
 	int i;
+	int first, last;
+	sc_bool_t train;
 
 	adjust_dcd_table(dcd_table, dcd_table_size);
 
+	/* Training cache key covers the adjusted table */
+	board_ddr_train_key.dcd = ddr_train_checksum(dcd_table,
+		U32(dcd_table_size) * sizeof(struct dram_cfg_param));
+	train = dcd_train_span(dcd_table, dcd_table_size, &first, &last);
+
 	for (i = 0; i < dcd_table_size; i++) {
 		struct dram_cfg_param *p = &dcd_table[i];
 
+		/* Restore cached training results instead of training */
+		if ((train == SC_TRUE) && (i == first)
+		    && (ddr_train_restore(&board_ddr_train_key,
+					  BD_DDR_RET_NUM_DRC) != SC_FALSE)) {
+			train = SC_FALSE;
+			i = last;
+			continue;
+		}
+
 		switch (p->cmd) {
 			case DCD_WRITE:
 				DATA4(p->reg, p->val);
@@ -681,6 +1021,9 @@ static void board_dcd_config(void)
 			default:
 				break;
 		}
+
+		if ((train == SC_TRUE) && (i == last))
+			ddr_train_save(&board_ddr_train_key, BD_DDR_RET_NUM_DRC);
 	}
 }
 
@@ -715,13 +1058,16 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
             board_ddr_derate_periodic_enable(SC_FALSE);
     #endif
             board_ddr_periodic_enable(SC_FALSE);
+            ddr_perf_pause(SC_TRUE);
     #ifdef BD_DDR_RET
+            ddr_ret_save();
             soc_ddr_enter_retention();
     #endif
             break;
         case BOARD_DDR_SR_DRC_OFF_EXIT:
     #ifdef BD_DDR_RET
             soc_ddr_exit_retention();
+            ddr_ret_restore();
     #endif
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
             ddrc_lpddr4_derate_init(BD_DDR_RET_NUM_DRC);
@@ -731,12 +1077,14 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
             soc_ddr_dqs2dq_init();
     #endif
             board_ddr_periodic_enable(SC_TRUE);
+            ddr_perf_pause(SC_FALSE);
             break;
         case BOARD_DDR_SR_DRC_ON_ENTER:
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
             board_ddr_derate_periodic_enable(SC_FALSE);
     #endif
             board_ddr_periodic_enable(SC_FALSE);
+            ddr_perf_pause(SC_TRUE);
             soc_self_refresh_power_down_clk_disable_entry();
             break;
         case BOARD_DDR_SR_DRC_ON_EXIT:
@@ -749,12 +1097,14 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
             soc_ddr_dqs2dq_periodic();
     #endif
             board_ddr_periodic_enable(SC_TRUE);
+            ddr_perf_pause(SC_FALSE);
             break;
         case BOARD_DDR_PERIODIC_HALT:
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
             board_ddr_derate_periodic_enable(SC_FALSE);
     #endif
             board_ddr_periodic_enable(SC_FALSE);
+            ddr_perf_pause(SC_TRUE);
             break;
         case BOARD_DDR_PERIODIC_RESTART:
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
@@ -765,6 +1115,7 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
             soc_ddr_dqs2dq_periodic();
     #endif
             board_ddr_periodic_enable(SC_TRUE);
+            ddr_perf_pause(SC_FALSE);
             break;
     #ifdef LP4_MANUAL_DERATE_WORKAROUND
         case BOARD_DDR_DERATE_PERIODIC:
@@ -783,6 +1134,43 @@ sc_err_t  board_ddr_config(bool rom_caller, board_ddr_action_t action)
     return err;
 }
 
+/*--------------------------------------------------------------------------*/
+/* Build the DDR training cache key for this boot                           */
+/*--------------------------------------------------------------------------*/
+static void board_ddr_train_get_key(ddr_train_key_t *key)
+{
+    uint32_t rate = 0U;
+    #ifndef EMUL
+        uint8_t sense = 0U;
+    #endif
+
+    /* DRC clock rate */
+    if (rm_is_resource_avail(SC_R_DRC_0))
+    {
+        (void) pm_get_clock_rate(SC_PT, SC_R_DRC_0, SC_PM_CLK_MISC0,
+            &rate);
+    }
+
+    /* DCD checksum is filled in once the table has been adjusted */
+    key->dcd = 0U;
+    key->rate = rate;
+    key->board = OTP_UNIQUE_ID_L ^ OTP_UNIQUE_ID_H;
+
+    /*
+     * Temperature band, the thermal thresholds the PMIC reports crossed.
+     * Only the I2C is brought up, the PMIC is set up after DDR init.
+     */
+    key->band = 0U;
+    #ifndef EMUL
+        pmic_i2c_init();
+        if (I2C_READ(PMIC_0_ADDR, BRD_PF8100_THERMSENSE, &sense, 1U)
+            == I32(kStatus_Success))
+        {
+            key->band = U32(sense) & BRD_PF8100_THERM_MASK;
+        }
+    #endif
+}
+
 /*--------------------------------------------------------------------------*/
 /* Configure the system (inc. additional resource partitions)               */
 /*--------------------------------------------------------------------------*/
@@ -805,7 +1193,10 @@ sc_err_t board_system_config(sc_bool_t early, sc_rm_pt_t pt_boot)
     (void) boot_get_data(NULL, NULL, NULL, NULL, NULL, NULL, &alt_config,
         NULL, NULL, &no_ap);
 
+    board_pt_boot = pt_boot;
+
     board_print(3, "board_system_config(%d, %d)\n", early, alt_config);
+    board_boot_mark(BOARD_BOOT_CONFIG, U32(alt_config));
 
     /* Configure initial resource allocation (note additional allocation
        and assignments can be made by the SCFW clients at run-time */
@@ -823,6 +1214,9 @@ sc_err_t board_system_config(sc_bool_t early, sc_rm_pt_t pt_boot)
         /* Keep baseboard reset */
         BRD_ERR(rm_assign_pad(pt_boot, SC_PT, SC_P_SPI2_SDO));
 
+        /* Hold XRDC writes until the partitions are built */
+        xrdc_shadow_begin();
+
         /* Mark all resources as not movable */
         BRD_ERR(rm_set_resource_movable(pt_boot, SC_R_ALL, SC_R_ALL,
             SC_FALSE));
@@ -923,6 +1317,10 @@ sc_err_t board_system_config(sc_bool_t early, sc_rm_pt_t pt_boot)
         BRD_ERR(rm_assign_resource(pt_m4_0, pt_sh, SC_R_M4_0_PID3));
         BRD_ERR(rm_assign_resource(pt_m4_0, pt_sh, SC_R_M4_0_PID4));
 
+        /* Write the held XRDC updates */
+        xrdc_shadow_commit();
+        board_boot_mark(BOARD_BOOT_PART, 0U);
+
         #ifdef BOARD_RM_DUMP
             rm_dump(pt_boot);
         #endif
@@ -942,6 +1340,8 @@ sc_bool_t board_early_cpu(sc_rsrc_t cpu)
 {
     sc_bool_t rtn = SC_FALSE;
 
+    board_boot_mark(BOARD_BOOT_CPU, U32(cpu));
+
     if ((cpu == SC_R_M4_0_PID0) || (cpu == SC_R_M4_1_PID0))
     {
         rtn = SC_TRUE;
@@ -978,7 +1378,7 @@ void board_set_power_mode(sc_sub_t ss, uint8_t pd,
                     SW_RUN_PWM | SW_STBY_PWM);
                 idx++;
             }
-            SystemTimeDelay(PMIC_MAX_RAMP);
+            BOARD_DELAY(PMIC_MAX_RAMP);
         }
         else
         {
@@ -1025,10 +1425,32 @@ sc_err_t board_set_voltage(sc_sub_t ss, uint32_t new_volt, uint32_t old_volt)
         }
         if ((old_volt != 0U) && (new_volt > old_volt))
         {
-            /* PMIC_MAX_RAMP_RATE is in nano Volts. */
-            uint32_t ramp_time = ((new_volt - old_volt) * 1000U)
-                / PMIC_MAX_RAMP_RATE;
-            SystemTimeDelay(ramp_time + 1U);
+            /* Rising, wait for power good before the load is raised */
+            static const pmic_id_t pmic_id = PMIC_0_ADDR;
+            uint32_t settle = pmic_ramp_time(old_volt, new_volt,
+                PMIC_MAX_RAMP_RATE);
+
+            if (pmic_ramp_wait(&pmic_id, &pmic_reg, MIN(U32(num_regs), 1U),
+                settle, settle + PMIC_MAX_RAMP) != SC_ERR_NONE)
+            {
+                board_print(1, "%s ramp timeout\n", snames[ss]);
+            }
+        }
+        else if (new_volt < old_volt)
+        {
+            /* Falling, the load is already lowered so do not block */
+            uint32_t settle = pmic_ramp_time(old_volt, new_volt,
+                PMIC_MAX_RAMP_RATE);
+
+            if (num_regs != 0U)
+            {
+                (void) pmic_ramp_start(PMIC_0_ADDR, pmic_reg, settle,
+                    settle + PMIC_MAX_RAMP, board_ramp_done);
+            }
+        }
+        else
+        {
+            ; /* Intentional empty else */
         }
     }
 
@@ -1382,14 +1804,23 @@ sc_err_t board_get_control(sc_rsrc_t resource, sc_rm_idx_t idx,
 /* PMIC Interrupt (INTB) handler                                            */
 /*--------------------------------------------------------------------------*/
 void PMIC_IRQHandler(void)
+{
+    /* Mask INTB and defer the I2C servicing to the board worker */
+    board_irq_defer_raise(&pmic_irq);
+}
+
+/*--------------------------------------------------------------------------*/
+/* PMIC interrupt bottom half                                               */
+/*--------------------------------------------------------------------------*/
+static void pmic_irq_work(void)
 {
     if (PMIC_IRQ_SERVICE(PMIC_0_ADDR))
     {
-        ss_irq_trigger(SC_IRQ_GROUP_TEMP, SC_IRQ_TEMP_PMIC0_HIGH,
+        board_notify(SC_IRQ_GROUP_TEMP, SC_IRQ_TEMP_PMIC0_HIGH,
             SC_PT_ALL);
     }
 
-    NVIC_ClearPendingIRQ(PMIC_INT_IRQn);
+    board_irq_defer_done(&pmic_irq);
 }
 
 /*--------------------------------------------------------------------------*/
@@ -1399,11 +1830,66 @@ void SNVS_Button_IRQHandler(void)
 {
     SNVS_ClearButtonIRQ();
 
-    ss_irq_trigger(SC_IRQ_GROUP_WAKE, SC_IRQ_BUTTON, SC_PT_ALL);
+    board_notify(SC_IRQ_GROUP_WAKE, SC_IRQ_BUTTON, SC_PT_ALL);
+}
+
+/*--------------------------------------------------------------------------*/
+/* PMIC LPI2C Handler                                                       */
+/*--------------------------------------------------------------------------*/
+void LPI2C0_IRQHandler(void)
+{
+    i2c_queue_irq_handler();
 }
 
 /*==========================================================================*/
 
+#ifndef EMUL
+/*--------------------------------------------------------------------------*/
+/* Init the I2C to the PMIC                                                 */
+/*--------------------------------------------------------------------------*/
+static void pmic_i2c_init(void)
+{
+    static sc_bool_t i2c_ready = SC_FALSE;
+    static lpi2c_master_config_t lpi2c_masterConfig;
+    sc_pm_clock_rate_t rate = SC_24MHZ;
+
+    if (i2c_ready == SC_FALSE)
+    {
+        i2c_ready = SC_TRUE;
+
+        /* Power up the I2C and configure clocks */
+        pm_force_resource_power_mode_v(SC_R_SC_I2C,
+            SC_PM_PW_MODE_ON);
+        (void) pm_set_clock_rate(SC_PT, SC_R_SC_I2C,
+            SC_PM_CLK_PER, &rate);
+        (void) pm_force_clock_enable(SC_R_SC_I2C, SC_PM_CLK_PER,
+            SC_TRUE);
+
+        /* Initialize the pads used to communicate with the PMIC */
+        pad_force_mux(SC_P_PMIC_I2C_SDA, 0,
+            SC_PAD_CONFIG_OD_IN, SC_PAD_ISO_OFF);
+        (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_I2C_SDA,
+            SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
+        pad_force_mux(SC_P_PMIC_I2C_SCL, 0,
+            SC_PAD_CONFIG_OD_IN, SC_PAD_ISO_OFF);
+        (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_I2C_SCL,
+            SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
+
+        /* Initialize the I2C used to communicate with the PMIC */
+        LPI2C_MasterGetDefaultConfig(&lpi2c_masterConfig);
+
+        /* MEK board spec is for 1M baud for PMIC I2C bus */
+        lpi2c_masterConfig.baudRate_Hz = 1000000U;
+        lpi2c_masterConfig.sdaGlitchFilterWidth_ns = 100U;
+        lpi2c_masterConfig.sclGlitchFilterWidth_ns = 100U;
+        LPI2C_MasterInit(LPI2C_PMIC, &lpi2c_masterConfig, SC_24MHZ);
+
+        /* Delay to allow I2C to settle */
+        BOARD_DELAY(2U);
+    }
+}
+#endif
+
 /*--------------------------------------------------------------------------*/
 /* Init the PMIC interface                                                  */
 /*--------------------------------------------------------------------------*/
@@ -1411,8 +1897,6 @@ static void pmic_init(void)
 {
     #ifndef EMUL
         static sc_bool_t pmic_checked = SC_FALSE;
-        static lpi2c_master_config_t lpi2c_masterConfig;
-        sc_pm_clock_rate_t rate = SC_24MHZ;
 
         /* See if we already checked for the PMIC */
         if (pmic_checked == SC_FALSE)
@@ -1423,24 +1907,10 @@ static void pmic_init(void)
 
             /* Initialize the PMIC */
             board_print(3, "Start PMIC init\n");
+            board_boot_mark(BOARD_BOOT_PMIC, 0U);
 
-            /* Power up the I2C and configure clocks */
-            pm_force_resource_power_mode_v(SC_R_SC_I2C,
-                SC_PM_PW_MODE_ON);
-            (void) pm_set_clock_rate(SC_PT, SC_R_SC_I2C,
-                SC_PM_CLK_PER, &rate);
-            (void) pm_force_clock_enable(SC_R_SC_I2C, SC_PM_CLK_PER,
-                SC_TRUE);
-
-            /* Initialize the pads used to communicate with the PMIC */
-            pad_force_mux(SC_P_PMIC_I2C_SDA, 0,
-                SC_PAD_CONFIG_OD_IN, SC_PAD_ISO_OFF);
-            (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_I2C_SDA,
-                SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
-            pad_force_mux(SC_P_PMIC_I2C_SCL, 0,
-                SC_PAD_CONFIG_OD_IN, SC_PAD_ISO_OFF);
-            (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_I2C_SCL,
-                SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
+            /* Bring up the I2C to the PMIC */
+            pmic_i2c_init();
 
             /* Initialize the PMIC interrupt pad */
             pad_force_mux(SC_P_PMIC_INT_B, 0,
@@ -1448,17 +1918,8 @@ static void pmic_init(void)
             (void) pad_set_gp_28fdsoi(SC_PT, SC_P_PMIC_INT_B,
                 SC_PAD_28FDSOI_DSE_18V_1MA, SC_PAD_28FDSOI_PS_PU);
 
-            /* Initialize the I2C used to communicate with the PMIC */
-            LPI2C_MasterGetDefaultConfig(&lpi2c_masterConfig);
-
-            /* MEK board spec is for 1M baud for PMIC I2C bus */
-            lpi2c_masterConfig.baudRate_Hz = 1000000U;
-            lpi2c_masterConfig.sdaGlitchFilterWidth_ns = 100U;
-            lpi2c_masterConfig.sclGlitchFilterWidth_ns = 100U;
-            LPI2C_MasterInit(LPI2C_PMIC, &lpi2c_masterConfig, SC_24MHZ);
-
-            /* Delay to allow I2C to settle */
-            SystemTimeDelay(2U);
+            /* Run PMIC/EEPROM transfers from the LPI2C IRQ */
+            i2c_queue_init();
 
             pmic_ver = GET_PMIC_VERSION(PMIC_0_ADDR);
             temp_alarm = SET_PMIC_TEMP_ALARM(PMIC_0_ADDR,
@@ -1503,9 +1964,11 @@ static void pmic_init(void)
                     REG_STBY_MODE);
             }
 
-            /* Enable PMIC IRQ at NVIC level */
-            NVIC_EnableIRQ(PMIC_INT_IRQn);
+            /* Enable PMIC IRQ at NVIC level, serviced by the worker */
+            board_irq_defer_init(&pmic_irq, PMIC_INT_IRQn, pmic_irq_work);
 
+            board_boot_mark(BOARD_BOOT_PMIC_DONE,
+                U32(pmic_ver.device_id));
             board_print(3, "Finished  PMIC init\n\n");
         }
     #endif
@@ -1520,6 +1983,7 @@ static sc_err_t pmic_ignore_current_limit(uint8_t address,
     sc_err_t err = SC_ERR_NONE;
     uint8_t idx;
     uint8_t val = 0U;
+    uint8_t old;
     static const pf8100_vregs_t switchers[11] =
     {
         PF8100_SW1,
@@ -1535,6 +1999,10 @@ static sc_err_t pmic_ignore_current_limit(uint8_t address,
         PF8100_LDO4
     };
 
+    /* Pull the regulator block into the shadow in a few bursts */
+    (void) pf8100_pmic_prefetch(address, PF8100_SW1,
+        U8(PF8100_LDO4 - PF8100_SW1 + 1U));
+
     for (idx = 0U; idx < 11U; idx++)
     {
         /* Read the config register first */
@@ -1543,6 +2011,7 @@ static sc_err_t pmic_ignore_current_limit(uint8_t address,
 
         if (err == SC_ERR_NONE)
         {
+            old = val;
     		if (ver.si_rev == PF8100_A0_REV)
     		{   /* only bypass current limit for A0 silicon */
     			val |= 0x20U; /* set xx_ILIM_BYPASS */
@@ -1563,8 +2032,11 @@ static sc_err_t pmic_ignore_current_limit(uint8_t address,
                 val |= 0xC0U;
             }
 
-            err = PMIC_REGISTER_ACCESS(address, switchers[idx], SC_TRUE,
-                &val);
+            if (val != old)
+            {
+                err = PMIC_REGISTER_ACCESS(address, switchers[idx], SC_TRUE,
+                    &val);
+            }
         }
 
         if (err != SC_ERR_NONE)
@@ -1603,6 +2075,17 @@ static sc_err_t pmic_update_timing(uint8_t address)
     return err;
 }
 
+/*--------------------------------------------------------------------------*/
+/* Completion of a non-blocking voltage ramp                                */
+/*--------------------------------------------------------------------------*/
+static void board_ramp_done(pmic_id_t id, uint32_t pmic_reg, sc_err_t err)
+{
+    if (err != SC_ERR_NONE)
+    {
+        board_print(1, "PMIC 0x%x reg 0x%x ramp timeout\n", id, pmic_reg);
+    }
+}
+
 /*--------------------------------------------------------------------------*/
 /* Get the pmic ids and switchers connected to SS.                          */
 /*--------------------------------------------------------------------------*/
@@ -1650,9 +2133,150 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
     always_print("IOCTL Function called! Cmd is %d, Buffer Addr is 0x%08x, Size is 0x%08x\n",
 			*command, *p1, *p2);
 
-    /* For test_misc */
     switch (*command) {
 
+	/* Batched RPC calls: p1 = message array, p2 = number of calls */
+	case SCFW_RPC_BATCH:
+		err = board_rpc_batch(caller_pt, mu, (sc_rpc_msg_t *)*p1, p2);
+		break;
+
+	/* DDR bandwidth: p1 = ddr_perf_stats_t buffer, p2 = DRC index */
+	case SCFW_DDR_PERF_GET:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(ddr_perf_stats_t));
+		if (err == SC_ERR_NONE)
+			err = ddr_perf_get_stats(*p2, (ddr_perf_stats_t *)buff);
+		break;
+
+	/* DDR bandwidth sampling: p1 = enable flag */
+	case SCFW_DDR_PERF_ENABLE:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			ddr_perf_enable((*p1 != 0U) ? SC_TRUE : SC_FALSE);
+		break;
+
+	/* DVFS governor: p1 = resource, p2 = enable flag */
+	case SCFW_DVFS_ENABLE:
+		err = dvfs_enable(caller_pt, (sc_rsrc_t)*p1,
+			(*p2 != 0U) ? SC_TRUE : SC_FALSE);
+		break;
+
+	/* DVFS performance floor: p1 = resource, p2 = rate in Hz */
+	case SCFW_DVFS_FLOOR:
+		err = dvfs_set_floor(caller_pt, (sc_rsrc_t)*p1, *p2);
+		break;
+
+	/* DVFS load hint: p1 = resource, p2 = load in % */
+	case SCFW_DVFS_HINT:
+		err = dvfs_hint(caller_pt, (sc_rsrc_t)*p1, *p2);
+		break;
+
+	/* DVFS statistics: p1 = dvfs_stats_t buffer, p2 = resource */
+	case SCFW_DVFS_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(dvfs_stats_t));
+		if (err == SC_ERR_NONE)
+			err = dvfs_get_stats((sc_rsrc_t)*p2, (dvfs_stats_t *)buff);
+		break;
+
+	case SCFW_PMIC_RAMP_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(pmic_ramp_stats_t));
+		if (err == SC_ERR_NONE)
+			pmic_ramp_get_stats((pmic_ramp_stats_t *)buff);
+		break;
+
+	case SCFW_PMIC_IRQ_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(board_irq_stats_t));
+		if (err == SC_ERR_NONE)
+			*(board_irq_stats_t *)buff = pmic_irq.stats;
+		break;
+
+	/* Partition notification coalescing: p1 = window in mS */
+	case SCFW_NOTIFY_CONFIG:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			board_notify_config(*p1);
+		break;
+
+	/* p1 = mask of BIT(group) delivered immediately to the caller */
+	case SCFW_NOTIFY_IMMEDIATE:
+		board_notify_immediate(caller_pt, *p1);
+		err = SC_ERR_NONE;
+		break;
+
+	case SCFW_NOTIFY_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(board_notify_stats_t));
+		if (err == SC_ERR_NONE)
+			board_notify_get_stats((board_notify_stats_t *)buff);
+		break;
+
+	/* RPC flight recorder dump: p1 = buffer, p2 = size, returns used */
+	case SCFW_RPC_REC_DUMP:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			err = board_check_caller_buf(caller_pt, buff, size);
+		if (err == SC_ERR_NONE)
+			err = rpc_rec_dump(caller_pt, buff, p2);
+		break;
+
+	case SCFW_RPC_REC_ENABLE:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			rpc_rec_enable((*p1 != 0U) ? SC_TRUE : SC_FALSE);
+		break;
+
+	/* Resources and pads owned by the caller as bitsets */
+	case SCFW_RM_INDEX:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(rm_index_t));
+		if (err == SC_ERR_NONE)
+			rm_index_build(caller_pt, (rm_index_t *)buff);
+		break;
+
+	case SCFW_XRDC_SHADOW_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(xrdc_shadow_stats_t));
+		if (err == SC_ERR_NONE)
+			xrdc_shadow_get_stats((xrdc_shadow_stats_t *)buff);
+		break;
+
+	/* Boot ledger: p1 = buffer, p2 = size, returns bytes written */
+	case SCFW_BOOT_LEDGER:
+		err = board_check_caller_buf(caller_pt, buff, size);
+		if (err == SC_ERR_NONE)
+			err = board_boot_dump(buff, p2);
+		break;
+
+	case SCFW_BOOT_LEDGER_PRINT:
+		board_boot_report();
+		err = SC_ERR_NONE;
+		break;
+
+	case SCFW_DDR_TRAIN_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(ddr_train_stats_t));
+		if (err == SC_ERR_NONE)
+			ddr_train_get_stats((ddr_train_stats_t *)buff);
+		break;
+
+	/* Drop cached training results, next boot trains in full */
+	case SCFW_DDR_TRAIN_DROP:
+		err = board_check_caller_ctrl(caller_pt, board_pt_boot);
+		if (err == SC_ERR_NONE)
+			ddr_train_invalidate();
+		break;
+
+	case SCFW_DDR_RET_STATS:
+		err = board_check_caller_buf(caller_pt, buff,
+			sizeof(ddr_ret_stats_t));
+		if (err == SC_ERR_NONE)
+			ddr_ret_get_stats((ddr_ret_stats_t *)buff);
+		break;
+
+	/* For test_misc */
 	case SOMINFO_READ_EEPROM:
 		always_print("EEPROM Read Function called, address=0x%08x!\n", buff);
 		if (size > 0x100) {
@@ -1660,7 +2284,7 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
 				always_print("EEPROM Read FAIL!\n");
 				break;
 			}
-			SystemTimeDelay(20000U);
+			BOARD_DELAY(20000U);
 			size -= 0x100;
 			buff += 0x100;
 			++i2c_addr;
@@ -1669,7 +2293,7 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
 			always_print("EEPROM Read FAIL!\n");
 			break;
 		}
-		SystemTimeDelay(20000U);
+		BOARD_DELAY(20000U);
 		always_print("EEPROM Read Success!\n");
 		err = SC_ERR_NONE;
 		break;
@@ -1684,7 +2308,7 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
 			break;
 		}
 
-		SystemTimeDelay(20000U);
+		BOARD_DELAY(20000U);
 
 		if (eeprom_i2c_write(EEPROM_I2C_ADDRESS, 0x02, buff+0x02, 14)) {
 			always_print("EEPROM Write block 0 FAIL!\n");
@@ -1692,7 +2316,7 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
 		}
 
 		for (i = 1; i < 16; i++) {
-			SystemTimeDelay(20000U);
+			BOARD_DELAY(20000U);
 			if (eeprom_i2c_write(EEPROM_I2C_ADDRESS, i*16, buff+i*16, 16)) {
 				always_print("EEPROM Write block %d FAIL!\n",i);
 				break;
@@ -1700,14 +2324,14 @@ sc_err_t board_ioctl(sc_rm_pt_t caller_pt, sc_rsrc_t mu, uint32_t *command,
 		}
 
 		for (i = 0; i < 16; i++) {
-			SystemTimeDelay(20000U);
+			BOARD_DELAY(20000U);
 			if (eeprom_i2c_write(EEPROM_I2C_ADDRESS+1, i*16, buff+256+i*16, 16)) {
 				always_print("EEPROM Write block %d FAIL!\n",i+16);
 				break;
 			}
 		}
 
-		SystemTimeDelay(20000U);
+		BOARD_DELAY(20000U);
 
 		if (eeprom_i2c_write(EEPROM_I2C_ADDRESS, 0x00, buff, 0x02)) {
 			always_print("EEPROM Magic Write FAIL!\n");
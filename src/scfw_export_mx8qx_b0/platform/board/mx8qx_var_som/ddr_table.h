@@ -14,6 +14,12 @@ struct __attribute__((packed)) dram_cfg_param {
 	uint32_t val;
 };
 
+/* Largest DCD table covered by the adjustment lookup index */
+#define DCD_INDEX_MAX 256
+
+/* PIR bits launching the PHY training steps, write leveling to VREF */
+#define DCD_PIR_TRAIN 0x0013FE00U
+
 extern struct dram_cfg_param dcd_table[];
 extern int dcd_table_size;
 
@@ -4,14 +4,20 @@
 #include "main/main.h"
 #include "fsl_device_registers.h"
 #include "drivers/lpi2c/fsl_lpi2c.h"
+#include "drivers/pmic/fsl_i2c_queue.h"
 #include "fsl_common.h"
 #include "all_svc.h"
+#include "drivers/sysctr/fsl_sysctr.h"
 
 #include "pads.h"
 #include "drivers/pad/fsl_pad.h"
 
+#include "eeprom.h"
+
 /* Local Variables */
 
+static struct eeprom_stats eeprom_stats;
+
 /*--------------------------------------------------------------------------*/
 /* Initialize EEPROM I2C bus                                                */
 /*--------------------------------------------------------------------------*/
@@ -43,7 +49,7 @@ void eeprom_i2c_init(void)
 	LPI2C_MasterInit(LPI2C_SC, &lpi2c_masterConfig, SC_24MHZ);
 
 	/* Delay to allow I2C to settle */
-	SystemTimeDelay(2U);
+	BOARD_DELAY(2U);
 }
 
 /*--------------------------------------------------------------------------*/
@@ -130,7 +136,19 @@ status_t eeprom_i2c_write(uint8_t device_addr, uint8_t reg, const void *data, ui
    
     return stat;
 #else
-    return eeprom_i2c_write_sub(device_addr, reg, data, dataLength);
+    status_t stat;
+
+    /* Share the PMIC transaction queue once it is up */
+    if (i2c_queue_active() != SC_FALSE)
+    {
+        stat = i2c_queue_write(device_addr, reg, data, dataLength);
+    }
+    else
+    {
+        stat = eeprom_i2c_write_sub(device_addr, reg, data, dataLength);
+    }
+
+    return stat;
 #endif
 }
 
@@ -195,12 +213,17 @@ static status_t eeprom_i2c_read_sub(uint8_t device_addr, uint8_t reg, void *data
 /*--------------------------------------------------------------------------*/
 status_t eeprom_i2c_read(uint8_t device_addr, uint8_t reg, void *data, uint32_t dataLength)
 {
+	uint32_t start = SYSCTR_GetUsec32();
+	status_t stat;
+
+	eeprom_stats.transactions++;
+
 #ifdef SC_MANAGE_LPI2C_CLK
     /* Enable clocking using LPCG */
     CLOCK_EnableClockEx(kCLOCK_LPI2C_SC);
 
     /* Do the transfer */
-    status_t stat = i2c_read_sub(device_addr, reg, data, dataLength);
+    stat = i2c_read_sub(device_addr, reg, data, dataLength);
 
     if(stat != I32(kStatus_Success))/* do a MasterStop if we ever fail */
     {
@@ -223,10 +246,57 @@ status_t eeprom_i2c_read(uint8_t device_addr, uint8_t reg, void *data, uint32_t
     
     /* Leave exclusive attempt to disable clock */
     CLOCK_DisableClockExLeave(kCLOCK_LPI2C_SC, lpcgVal);
-    
-    return stat;
 #else
-    return eeprom_i2c_read_sub(device_addr, reg, data, dataLength);
+    /* Share the PMIC transaction queue once it is up */
+    if (i2c_queue_active() != SC_FALSE)
+    {
+        stat = i2c_queue_read(device_addr, reg, data, dataLength);
+    }
+    else
+    {
+        stat = eeprom_i2c_read_sub(device_addr, reg, data, dataLength);
+    }
 #endif
+
+	if (stat == I32(kStatus_Success))
+		eeprom_stats.bytes += dataLength;
+	eeprom_stats.usec += SYSCTR_GetUsec32() - start;
+
+	return stat;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Read a region of the EEPROM using sequential-read transactions           */
+/*--------------------------------------------------------------------------*/
+status_t eeprom_i2c_read_bulk(uint8_t device_addr, uint8_t reg, void *data, uint32_t dataLength)
+{
+	uint8_t *buf = data;
+	uint32_t addr = reg;
+	uint32_t len;
+	status_t stat = I32(kStatus_Success);
+
+	/* The word address does not wrap usefully past the end of the part */
+	if ((addr + dataLength) > EEPROM_SIZE)
+		return I32(kStatus_InvalidArgument);
+
+	/* The EEPROM auto-increments its address on reads, so the only
+	   limit on a transaction is how long the bus is held */
+	while ((dataLength > 0U) && (stat == I32(kStatus_Success))) {
+		len = MIN(dataLength, EEPROM_READ_CHUNK);
+		stat = eeprom_i2c_read(device_addr, U8(addr), buf, len);
+		buf += len;
+		addr += len;
+		dataLength -= len;
+	}
+
+	return stat;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get EEPROM transfer statistics                                           */
+/*--------------------------------------------------------------------------*/
+void eeprom_get_stats(struct eeprom_stats *stats)
+{
+	*stats = eeprom_stats;
 }
 
@@ -3,15 +3,13 @@
 
 #define EEPROM_I2C_ADDRESS	0x52
 
-#define CTL_CODE(function, method) ((4 << 16) | ((function) << 2) | (method))
-
-#define METHOD_BUFFERED		0
-#define METHOD_NEITHER		3
+#define VAR_EEPROM_MAGIC	0x384D /* == HEX("8M") */
 
-#define SOMINFO_READ_EEPROM	CTL_CODE(2100, METHOD_BUFFERED)
-#define SOMINFO_WRITE_EEPROM	CTL_CODE(2101, METHOD_BUFFERED)
+/* Maximum bytes moved by one sequential EEPROM read transaction */
+#define EEPROM_READ_CHUNK	64U
 
-#define VAR_EEPROM_MAGIC	0x384D /* == HEX("8M") */
+/* EEPROM address space reachable with an 8-bit word address */
+#define EEPROM_SIZE		256U
 
 /* Number of DRAM adjustment tables */
 #define DRAM_TABLE_NUM 7
@@ -43,8 +41,18 @@ static inline int var_eeprom_is_valid(struct var_eeprom *e)
 	return 1;
 }
 
+/* EEPROM transfer accounting */
+struct eeprom_stats
+{
+	uint32_t transactions;         /* I2C read transactions issued */
+	uint32_t bytes;                /* bytes read                   */
+	uint32_t usec;                 /* time spent in reads          */
+};
+
 extern void eeprom_i2c_init(void);
 extern status_t eeprom_i2c_write(uint8_t device_addr, uint8_t reg, const void *data, uint32_t dataLength);
 extern status_t eeprom_i2c_read(uint8_t device_addr, uint8_t reg, void *data, uint32_t dataLength);
+extern status_t eeprom_i2c_read_bulk(uint8_t device_addr, uint8_t reg, void *data, uint32_t dataLength);
+extern void eeprom_get_stats(struct eeprom_stats *stats);
 
 #endif
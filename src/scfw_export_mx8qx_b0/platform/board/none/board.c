@@ -56,6 +56,7 @@
 #include "main/boot.h"
 #include "main/soc.h"
 #include "all_svc.h"
+#include "board/board_common.h"
 #include "drivers/wdog32/fsl_wdog32.h"
 #include "drivers/lpuart/fsl_lpuart.h"
 #include "pads.h"
@@ -103,6 +104,15 @@
     #define DEBUG_BAUD              115200U
 #endif
 
+/*!
+ * @name Supply Timing
+ * Modeled on the MEK PMIC so SIMU delay reports match a real board.
+ */
+/*@{*/
+#define PMIC_MAX_RAMP           141U    /* Max PMIC ramp delay in uS */
+#define PMIC_MAX_RAMP_RATE      7813U   /* PMIC voltage ramp (nV) per uS */
+/*@}*/
+
 /* Local Types */
 
 /* Local Functions */
@@ -169,6 +179,12 @@ const uint32_t board_ddr_derate_period_ms = 0U;
 void board_init(boot_phase_t phase)
 {
     ss_print(3, "board_init(%d)\n", phase);
+
+    /* No HW access (SYSCTR) in the API phase */
+    if (phase != BOOT_PHASE_API_INIT)
+    {
+        board_boot_mark(BOARD_BOOT_INIT, U32(phase));
+    }
 }
 
 /*--------------------------------------------------------------------------*/
@@ -265,6 +281,8 @@ sc_bool_t board_rsrc_avail(sc_rsrc_t rsrc)
 sc_err_t board_init_ddr(sc_bool_t early, sc_bool_t ddr_initalized)
 {
     board_print(3, "board_init_ddr(%d)\n", early);
+    board_boot_mark(BOARD_BOOT_DDR, U32(early));
+    board_boot_mark(BOARD_BOOT_DDR_DONE, U32(SC_ERR_UNAVAILABLE));
 
     return SC_ERR_UNAVAILABLE;
 }
@@ -292,6 +310,7 @@ sc_err_t board_system_config(sc_bool_t early, sc_rm_pt_t pt_boot)
        -p option. */
 
     board_print(3, "board_system_config(%d)\n", early);
+    board_boot_mark(BOARD_BOOT_CONFIG, 0U);
 
     return SC_ERR_UNAVAILABLE;
 }
@@ -301,6 +320,8 @@ sc_err_t board_system_config(sc_bool_t early, sc_rm_pt_t pt_boot)
 /*--------------------------------------------------------------------------*/
 sc_bool_t board_early_cpu(sc_rsrc_t cpu)
 {
+    board_boot_mark(BOARD_BOOT_CPU, U32(cpu));
+
     return SC_FALSE;
 }
 
@@ -312,6 +333,12 @@ void board_set_power_mode(sc_sub_t ss, uint8_t pd,
 {
     board_print(3, "board_set_power_mode(%s, %d, %d, %d)\n", snames[ss],
         pd, from_mode, to_mode);
+
+    /* Supply switched on */
+    if ((from_mode == SC_PM_PW_MODE_OFF) && (to_mode > SC_PM_PW_MODE_OFF))
+    {
+        BOARD_DELAY(PMIC_MAX_RAMP);
+    }
 }
 
 /*--------------------------------------------------------------------------*/
@@ -319,6 +346,14 @@ void board_set_power_mode(sc_sub_t ss, uint8_t pd,
 /*--------------------------------------------------------------------------*/
 sc_err_t board_set_voltage(sc_sub_t ss, uint32_t new_volt, uint32_t old_volt)
 {
+    if ((old_volt != 0U) && (new_volt > old_volt))
+    {
+        /* PMIC_MAX_RAMP_RATE is in nano Volts. */
+        uint32_t ramp_time = ((new_volt - old_volt) * 1000U)
+            / PMIC_MAX_RAMP_RATE;
+        BOARD_DELAY(ramp_time + 1U);
+    }
+
     return SC_ERR_NONE;
 }
 
@@ -46,123 +46,202 @@
 #include "main/main.h"
 #include "test/test.h"
 #include "board/pmic.h"
+#include "drivers/sysctr/fsl_sysctr.h"
+
+/* Local Types */
+
+/*!
+ * Pending non-blocking ramp
+ */
+typedef struct
+{
+    pmic_id_t id;
+    uint32_t pmic_reg;
+    uint64_t start;
+    uint64_t settle;
+    uint64_t deadline;
+    pmic_ramp_cb_t cb;
+    sc_bool_t busy;
+} pmic_ramp_t;
+
+/*!
+ * PMIC address bound to a driver, ops is NULL if nothing answered
+ */
+typedef struct
+{
+    pmic_id_t id;
+    const pmic_ops_t *ops;
+} pmic_dev_t;
 
 /* Declare a Global PMIC identifier for dynamic functions */
 uint8_t PMIC_TYPE = PMIC_NONE;
 
-/* Initialize PMIC_TYPE if not done from board file */
-static sc_err_t get_pmic_type(pmic_id_t id);
+static const pmic_ops_t *pmic_ops_find(pmic_id_t id);
+static const pmic_ops_t *pmic_ops_of(uint8_t type);
+
+static void pmic_ramp_account(uint64_t start, sc_err_t err);
+static void pmic_ramp_tick(void);
+static void pmic_ramp_poll(void);
+
+/* Local Variables */
+
+/*!
+ * Driver ops of each supported PMIC type
+ */
+static const pmic_ops_t pf100_ops =
+{
+    pf100_pmic_set_voltage,
+    pf100_pmic_get_voltage,
+    pf100_pmic_get_pg,
+    pf100_pmic_set_mode,
+    NULL,                   /* get mode not supported for pf100 */
+    pf100_pmic_irq_service,
+    pf100_pmic_register_access,
+    pf100_get_pmic_version,
+    pf100_get_pmic_temp,
+    pf100_set_pmic_temp_alarm
+};
+
+static const pmic_ops_t pf8100_ops =
+{
+    pf8100_pmic_set_voltage,
+    pf8100_pmic_get_voltage,
+    pf8100_pmic_get_pg,
+    pf8100_pmic_set_mode,
+    pf8100_pmic_get_mode,
+    pf8100_pmic_irq_service,
+    pf8100_pmic_register_access,
+    pf8100_get_pmic_version,
+    pf8100_get_pmic_temp,
+    pf8100_set_pmic_temp_alarm
+};
+
+static pmic_dev_t pmic_dev[PMIC_MAX_DEVS];
+static uint32_t pmic_num_dev = 0U;
+static uint32_t pmic_probes = 0U;
+
+static pmic_ramp_t pmic_ramp[PMIC_RAMP_SLOTS];
+static board_timer_t pmic_ramp_timer;
+static board_work_t pmic_ramp_work;
+static pmic_ramp_stats_t pmic_ramp_stats;
 
 /*--------------------------------------------------------------------------*/
-/* Set PMIC Regulator Voltage                                               */
+/* Bind a PMIC address to the driver of a type                              */
 /*--------------------------------------------------------------------------*/
-sc_err_t dynamic_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
-    uint32_t vol_mv, uint32_t mode_to_set)
+sc_err_t pmic_register(pmic_id_t id, uint8_t type)
 {
     sc_err_t rtn = SC_ERR_NONE;
-    
-    if (PMIC_TYPE == PMIC_NONE)
+    uint32_t i;
+
+    for (i = 0U; i < pmic_num_dev; i++)
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
+        if (pmic_dev[i].id == id)
         {
-            rtn = SC_ERR_FAIL;
+            break;
         }
     }
-    
-    /* Call specific function based on established PMIC_TYPE */
-    if (rtn == SC_ERR_NONE)
+
+    if (i < pmic_num_dev)
     {
-        switch (PMIC_TYPE)
-        {
-            case PF100 :
-                rtn = pf100_pmic_set_voltage(id, pmic_reg, vol_mv,
-                    mode_to_set);
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_pmic_set_voltage(id, pmic_reg, vol_mv,
-                    mode_to_set);
-                break;
-            default :
-                rtn = SC_ERR_NOTFOUND;
-                break;
-        }
+        pmic_dev[i].ops = pmic_ops_of(type);
+    }
+    else if (pmic_num_dev < PMIC_MAX_DEVS)
+    {
+        pmic_dev[pmic_num_dev].id = id;
+        pmic_dev[pmic_num_dev].ops = pmic_ops_of(type);
+        pmic_num_dev++;
+    }
+    else
+    {
+        rtn = SC_ERR_UNAVAILABLE;
     }
 
     return rtn;
 }
 
 /*--------------------------------------------------------------------------*/
-/* Get PMIC Regulator Voltage                                               */
+/* Probe a PMIC address and bind it                                         */
 /*--------------------------------------------------------------------------*/
-sc_err_t dynamic_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg, uint32_t *vol_mv,
-        uint32_t mode_to_get)
+uint8_t pmic_probe(pmic_id_t id)
 {
-    sc_err_t rtn = SC_ERR_NONE;
+    uint8_t type;
 
-    if (PMIC_TYPE == PMIC_NONE)
+    pmic_probes++;
+    switch (pmic_get_device_id(id))
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
-        {
-            rtn = SC_ERR_FAIL;
-        }
+        case PF100_DEV_ID :
+            type = PF100;
+            break;
+        case PF8100_DEV_ID :
+            type = PF8100;
+            break;
+        case PF8200_DEV_ID :
+            type = PF8200;
+            break;
+        default :
+            type = PMIC_NONE;
+            break;
     }
 
-    /* Call specific function based on established PMIC_TYPE */
-    if (rtn == SC_ERR_NONE)
+    /* An absent PMIC is bound too so it is not probed again */
+    (void) pmic_register(id, type);
+
+    return type;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get the number of probes done                                            */
+/*--------------------------------------------------------------------------*/
+uint32_t pmic_get_probes(void)
+{
+    return pmic_probes;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Set PMIC Regulator Voltage                                               */
+/*--------------------------------------------------------------------------*/
+sc_err_t dynamic_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
+    uint32_t vol_mv, uint32_t mode_to_set)
+{
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    sc_err_t rtn = SC_ERR_FAIL;
+
+    if (ops != NULL)
     {
-        switch (PMIC_TYPE)
-        {
-            case PF100 :
-                rtn = pf100_pmic_get_voltage(id, pmic_reg, vol_mv, mode_to_get);
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_pmic_get_voltage(id, pmic_reg, vol_mv, mode_to_get);
-                break;
-            default :
-                rtn = SC_ERR_NOTFOUND;
-                break;
-        }
+        rtn = ops->set_voltage(id, pmic_reg, vol_mv, mode_to_set);
     }
 
     return rtn;
 }
 
 /*--------------------------------------------------------------------------*/
-/* Set PMIC Regulator Mode                                                  */
+/* Get PMIC Regulator Voltage                                               */
 /*--------------------------------------------------------------------------*/
-sc_err_t dynamic_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
+sc_err_t dynamic_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg, uint32_t *vol_mv,
+        uint32_t mode_to_get)
 {
-    sc_err_t rtn = SC_ERR_NONE;
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    sc_err_t rtn = SC_ERR_FAIL;
 
-    if (PMIC_TYPE == PMIC_NONE)
+    if (ops != NULL)
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
-        {
-            rtn = SC_ERR_FAIL;
-        }
+        rtn = ops->get_voltage(id, pmic_reg, vol_mv, mode_to_get);
     }
 
-    /* Call specific function based on established PMIC_TYPE */
-    if (rtn == SC_ERR_NONE)
+    return rtn;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Set PMIC Regulator Mode                                                  */
+/*--------------------------------------------------------------------------*/
+sc_err_t dynamic_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
+{
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    sc_err_t rtn = SC_ERR_FAIL;
+
+    if (ops != NULL)
     {
-        switch (PMIC_TYPE)
-        {
-            case PF100 :
-                rtn = pf100_pmic_set_mode(id, pmic_reg, mode);
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_pmic_set_mode(id, pmic_reg, mode);
-                break;
-            default :
-                rtn = SC_ERR_NOTFOUND;
-                break;
-        }
+        rtn = ops->set_mode(id, pmic_reg, mode);
     }
 
     return rtn;
@@ -173,32 +252,18 @@ sc_err_t dynamic_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
 /*--------------------------------------------------------------------------*/
 sc_err_t dynamic_pmic_get_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t *mode)
 {
-    sc_err_t rtn = SC_ERR_NONE;
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    sc_err_t rtn = SC_ERR_FAIL;
 
-    if (PMIC_TYPE == PMIC_NONE)
+    if (ops != NULL)
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
+        if (ops->get_mode != NULL)
         {
-            rtn = SC_ERR_FAIL;
+            rtn = ops->get_mode(id, pmic_reg, mode);
         }
-    }
-
-    /* Call specific function based on established PMIC_TYPE */
-    if (rtn == SC_ERR_NONE)
-    {
-        switch (PMIC_TYPE)
+        else
         {
-            case PF100 : /* get mode not supported for pf100 */
-                rtn = SC_ERR_NOTFOUND;
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_pmic_get_mode(id, pmic_reg, mode);
-                break;
-            default :
-                rtn = SC_ERR_NOTFOUND;
-                break;
+            rtn = SC_ERR_NOTFOUND;
         }
     }
 
@@ -206,37 +271,32 @@ sc_err_t dynamic_pmic_get_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t *mode)
 }
 
 /*--------------------------------------------------------------------------*/
-/* Service PMIC IRQ                                                         */
+/* Get PMIC Regulator Power Good                                            */
 /*--------------------------------------------------------------------------*/
-sc_bool_t dynamic_pmic_irq_service(pmic_id_t id)
+sc_err_t dynamic_pmic_get_pg(pmic_id_t id, uint32_t pmic_reg, sc_bool_t *pg)
 {
-    sc_bool_t rtn = SC_TRUE;
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    sc_err_t rtn = SC_ERR_FAIL;
 
-    if (PMIC_TYPE == PMIC_NONE)
+    if (ops != NULL)
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
-        {
-            rtn = SC_FALSE;
-        }
+        rtn = ops->get_pg(id, pmic_reg, pg);
     }
 
-    /* Call specific function based on established PMIC_TYPE */
-    if (rtn == SC_TRUE)
+    return rtn;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Service PMIC IRQ                                                         */
+/*--------------------------------------------------------------------------*/
+sc_bool_t dynamic_pmic_irq_service(pmic_id_t id)
+{
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    sc_bool_t rtn = SC_FALSE;
+
+    if (ops != NULL)
     {
-        switch (PMIC_TYPE)
-        {
-            case PF100 :
-                rtn = pf100_pmic_irq_service(id);
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_pmic_irq_service(id);
-                break;
-            default :
-                rtn = SC_FALSE;
-                break;
-        }
+        rtn = ops->irq_service(id);
     }
 
     return rtn;
@@ -248,33 +308,12 @@ sc_bool_t dynamic_pmic_irq_service(pmic_id_t id)
 sc_err_t dynamic_pmic_register_access(pmic_id_t id, uint32_t address,
                                       sc_bool_t read_write, uint8_t* value)
 {
-    sc_err_t rtn = SC_ERR_NONE;
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    sc_err_t rtn = SC_ERR_FAIL;
 
-    if (PMIC_TYPE == PMIC_NONE)
+    if (ops != NULL)
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
-        {
-            rtn = SC_ERR_FAIL;
-        }
-    }
-
-    /* Call specific function based on established PMIC_TYPE */
-    if (rtn == SC_ERR_NONE)
-    {
-        switch (PMIC_TYPE)
-        {
-            case PF100 :
-                rtn = pf100_pmic_register_access(id, address, read_write, value);
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_pmic_register_access(id, address, read_write, value);
-                break;
-            default :
-                rtn = SC_ERR_NOTFOUND;
-                break;
-        }
+        rtn = ops->register_access(id, address, read_write, value);
     }
 
     return rtn;
@@ -285,139 +324,320 @@ sc_err_t dynamic_pmic_register_access(pmic_id_t id, uint32_t address,
 /*--------------------------------------------------------------------------*/
 pmic_version_t dynamic_get_pmic_version(pmic_id_t id)
 {
+    const pmic_ops_t *ops = pmic_ops_find(id);
     pmic_version_t rtn = {0, 0}; /* initialize to empty as err return */
-    sc_bool_t set = SC_TRUE;
 
-    if (PMIC_TYPE == PMIC_NONE)
+    if (ops != NULL)
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
-        {
-            set = SC_FALSE;
-        }
+        rtn = ops->get_version(id);
     }
 
-	/* skip switch statement if PMIC type not detected */
-    if (set != SC_FALSE)
+    return rtn;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Get PMIC temperature                                                     */
+/*--------------------------------------------------------------------------*/
+uint32_t dynamic_get_pmic_temp(pmic_id_t id)
+{
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    uint32_t rtn = 25U; /* default to room temp */
+
+    if (ops != NULL)
     {
-		/* Call specific function based on established PMIC_TYPE */
-        switch (PMIC_TYPE)
-        {
-            case PF100 :
-                rtn = pf100_get_pmic_version(id);
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_get_pmic_version(id);
-                break;
-            default :
-                /* default case leaves rtn as empty version */
-                break;
-        }
+        rtn = ops->get_temp(id);
     }
 
     return rtn;
 }
 
 /*--------------------------------------------------------------------------*/
-/* Get PMIC temperature                                                     */
+/* Set PMIC Temperature Alarm                                               */
 /*--------------------------------------------------------------------------*/
-uint32_t dynamic_get_pmic_temp(pmic_id_t id)
+uint32_t dynamic_set_pmic_temp_alarm(pmic_id_t id, uint32_t temp)
+{
+    const pmic_ops_t *ops = pmic_ops_find(id);
+    uint32_t rtn = temp; /* return temp called with */
+
+    if (ops != NULL)
+    {
+        rtn = ops->set_temp_alarm(id, temp);
+    }
+
+    return rtn;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Expected settle time of a voltage change                                 */
+/*--------------------------------------------------------------------------*/
+uint32_t pmic_ramp_time(uint32_t old_mv, uint32_t new_mv, uint32_t rate)
 {
-    uint32_t rtn = 0U;
-    uint32_t default_temp = 25U;
+    uint32_t delta = (new_mv > old_mv) ? (new_mv - old_mv)
+        : (old_mv - new_mv);
+
+    return ((delta * 1000U) + rate - 1U) / rate;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Wait for regulators to settle                                            */
+/*--------------------------------------------------------------------------*/
+sc_err_t pmic_ramp_wait(const pmic_id_t *id, const uint32_t *pmic_reg,
+    uint32_t num, uint32_t settle_us, uint32_t timeout_us)
+{
+    /* Bound the time the caller blocks */
+    uint32_t timeout = MIN(timeout_us, PMIC_RAMP_WAIT_MAX_US);
+    uint32_t settle = MIN(settle_us, timeout);
+    uint64_t start = board_get_counter64();
+    uint64_t deadline = start + SYSCTR_USEC_TO_TICKS64(timeout);
+    sc_err_t err = SC_ERR_NONE;
+    uint32_t idx = 0U;
+
+    /* The outputs cannot be there before the slew allows */
+    if (settle != 0U)
+    {
+        BOARD_DELAY(settle);
+    }
 
-    if (PMIC_TYPE == PMIC_NONE)
+    /* Poll the rails in turn against the one deadline */
+    while ((err == SC_ERR_NONE) && (idx < num))
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
+        sc_bool_t pg = SC_FALSE;
+
+        err = PMIC_GET_PG(id[idx], pmic_reg[idx], &pg);
+        if ((err == SC_ERR_NONE) && (pg != SC_FALSE))
+        {
+            idx++;
+        }
+        else if (err == SC_ERR_NONE)
         {
-            rtn = default_temp; /* default to room temp */
+            if (board_get_counter64() >= deadline)
+            {
+                err = SC_ERR_BUSY;
+            }
+            else
+            {
+                pmic_ramp_stats.polls++;
+                BOARD_DELAY(PMIC_RAMP_POLL_US);
+            }
         }
+        else
+        {
+            ; /* Intentional empty else */
+        }
+    }
+
+    /* No power good sense, the slew time has to do */
+    if (err == SC_ERR_UNAVAILABLE)
+    {
+        err = SC_ERR_NONE;
     }
 
-    /* Call specific function based on established PMIC_TYPE */
-    if (rtn == 0U)
+    pmic_ramp_account(start, err);
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Track a ramp without blocking                                            */
+/*--------------------------------------------------------------------------*/
+sc_err_t pmic_ramp_start(pmic_id_t id, uint32_t pmic_reg, uint32_t settle_us,
+    uint32_t timeout_us, pmic_ramp_cb_t cb)
+{
+    sc_err_t err = SC_ERR_UNAVAILABLE;
+    uint32_t i;
+
+    for (i = 0U; i < PMIC_RAMP_SLOTS; i++)
     {
-        switch (PMIC_TYPE)
+        pmic_ramp_t *ramp = &pmic_ramp[i];
+
+        if (ramp->busy == SC_FALSE)
         {
-            case PF100 :
-                rtn = pf100_get_pmic_temp(id);
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_get_pmic_temp(id);
-                break;
-            default :
-                rtn = default_temp;
-                break;
+            ramp->id = id;
+            ramp->pmic_reg = pmic_reg;
+            ramp->start = board_get_counter64();
+            ramp->settle = ramp->start + SYSCTR_USEC_TO_TICKS64(settle_us);
+            ramp->deadline = ramp->start
+                + SYSCTR_USEC_TO_TICKS64(timeout_us);
+            ramp->cb = cb;
+            ramp->busy = SC_TRUE;
+
+            /* Poll every tick while anything is pending */
+            if (pmic_ramp_timer.active == SC_FALSE)
+            {
+                board_timer_start(&pmic_ramp_timer, pmic_ramp_tick, 1U, 1U);
+            }
+
+            err = SC_ERR_NONE;
+            break;
         }
     }
 
-    return rtn;
+    return err;
 }
 
 /*--------------------------------------------------------------------------*/
-/* Set PMIC Temperature Alarm                                               */
+/* Get ramp latency statistics                                              */
 /*--------------------------------------------------------------------------*/
-uint32_t dynamic_set_pmic_temp_alarm(pmic_id_t id, uint32_t temp)
+void pmic_ramp_get_stats(pmic_ramp_stats_t *stats)
 {
-    uint32_t rtn = 0U;
+    *stats = pmic_ramp_stats;
+}
 
-    if (PMIC_TYPE == PMIC_NONE)
+/*--------------------------------------------------------------------------*/
+/* Record the latency of a completed ramp                                   */
+/*--------------------------------------------------------------------------*/
+static void pmic_ramp_account(uint64_t start, sc_err_t err)
+{
+    uint32_t usec = U32(SYSCTR_TICKS_TO_USEC64(board_get_counter64()
+        - start));
+    uint32_t v = usec >> 4U;
+    uint32_t bucket = 0U;
+
+    while ((v != 0U) && (bucket < (PMIC_RAMP_BUCKETS - 1U)))
     {
-        /* Initialize PMIC_TYPE if not already */
-        if(get_pmic_type(id) != SC_ERR_NONE)
+        v >>= 1U;
+        bucket++;
+    }
+
+    pmic_ramp_stats.ramps++;
+    pmic_ramp_stats.hist[bucket]++;
+    if (usec > pmic_ramp_stats.max_usec)
+    {
+        pmic_ramp_stats.max_usec = usec;
+    }
+    if (err == SC_ERR_BUSY)
+    {
+        pmic_ramp_stats.timeouts++;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Ramp timer, interrupt context so only hand the poll to the worker        */
+/*--------------------------------------------------------------------------*/
+static void pmic_ramp_tick(void)
+{
+    board_work_post(&pmic_ramp_work, pmic_ramp_poll);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Poll pending ramps, called from the board worker                         */
+/*--------------------------------------------------------------------------*/
+static void pmic_ramp_poll(void)
+{
+    sc_bool_t pending = SC_FALSE;
+    uint32_t i;
+
+    for (i = 0U; i < PMIC_RAMP_SLOTS; i++)
+    {
+        pmic_ramp_t *ramp = &pmic_ramp[i];
+        uint64_t now = board_get_counter64();
+        sc_bool_t pg = SC_FALSE;
+        sc_err_t err;
+
+        if (ramp->busy == SC_FALSE)
+        {
+            continue;
+        }
+        if (now < ramp->settle)
+        {
+            pending = SC_TRUE;
+            continue;
+        }
+
+        pmic_ramp_stats.polls++;
+        err = PMIC_GET_PG(ramp->id, ramp->pmic_reg, &pg);
+        if (err == SC_ERR_UNAVAILABLE)
+        {
+            /* No power good sense, complete after the slew time */
+            err = SC_ERR_NONE;
+            pg = SC_TRUE;
+        }
+        else if ((err == SC_ERR_NONE) && (pg == SC_FALSE)
+            && (now >= ramp->deadline))
         {
-            rtn = temp; /* return temp called with */
+            err = SC_ERR_BUSY;
+        }
+        else
+        {
+            ; /* Intentional empty else */
+        }
+
+        if ((err != SC_ERR_NONE) || (pg != SC_FALSE))
+        {
+            ramp->busy = SC_FALSE;
+            pmic_ramp_account(ramp->start, err);
+            if (ramp->cb != NULL)
+            {
+                ramp->cb(ramp->id, ramp->pmic_reg, err);
+            }
+        }
+        else
+        {
+            pending = SC_TRUE;
         }
     }
 
-    /* Call specific function based on established PMIC_TYPE */
-    if (rtn == 0U)
+    if (pending == SC_FALSE)
+    {
+        board_timer_stop(&pmic_ramp_timer);
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Find the driver bound to a PMIC address                                  */
+/*--------------------------------------------------------------------------*/
+static const pmic_ops_t *pmic_ops_find(pmic_id_t id)
+{
+    const pmic_ops_t *ops = NULL;
+    uint32_t i;
+
+    for (i = 0U; i < pmic_num_dev; i++)
     {
-        switch (PMIC_TYPE)
+        if (pmic_dev[i].id == id)
         {
-            case PF100 :
-                rtn = pf100_set_pmic_temp_alarm(id, temp);
-                break;
-            case PF8100 :
-            case PF8200 :
-                rtn = pf8100_set_pmic_temp_alarm(id, temp);
-                break;
-            default :
-                rtn = temp;
-                break;
+            break;
         }
     }
 
-    return rtn;
+    if (i < pmic_num_dev)
+    {
+        ops = pmic_dev[i].ops;
+    }
+    else if (PMIC_TYPE != PMIC_NONE)
+    {
+        /* Board set the type for all PMICs, bind without probing */
+        (void) pmic_register(id, PMIC_TYPE);
+        ops = pmic_ops_of(PMIC_TYPE);
+    }
+    else
+    {
+        /* First use of an unknown address, probe it once */
+        ops = pmic_ops_of(pmic_probe(id));
+    }
+
+    return ops;
 }
 
 /*--------------------------------------------------------------------------*/
-/* Determine PMIC type at address                                           */
+/* Get the driver ops of a PMIC type                                        */
 /*--------------------------------------------------------------------------*/
-static sc_err_t get_pmic_type(pmic_id_t id)
+static const pmic_ops_t *pmic_ops_of(uint8_t type)
 {
-    uint8_t dev_id = pmic_get_device_id(id);
-    sc_err_t rtn = SC_ERR_NONE;
+    const pmic_ops_t *ops;
 
-    switch (dev_id)
+    switch (type)
     {
-        case PF100_DEV_ID :
-            PMIC_TYPE = PF100;
-            break;
-        case PF8100_DEV_ID :
-            PMIC_TYPE = PF8100;
+        case PF100 :
+            ops = &pf100_ops;
             break;
-        case PF8200_DEV_ID :
-            PMIC_TYPE = PF8200;
+        case PF8100 :
+        case PF8200 :
+            ops = &pf8100_ops;
             break;
         default :
-            PMIC_TYPE = PMIC_NONE;
-            rtn = SC_ERR_NOTFOUND;
+            ops = NULL;
             break;
     }
 
-    return rtn;
+    return ops;
 }
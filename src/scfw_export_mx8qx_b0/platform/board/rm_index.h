@@ -0,0 +1,122 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Header file for the board resource ownership index. Snapshots the
+ * resources and pads a partition owns into bitsets so ownership can be
+ * tested with a bit test and listed in one client call.
+ *
+ * @addtogroup BRD_SVC (BRD) Board Interface
+ *
+ * @{
+ */
+/*==========================================================================*/
+
+#ifndef SC_RM_INDEX_H
+#define SC_RM_INDEX_H
+
+/* Includes */
+
+#include "main/types.h"
+#include "svc/rm/api.h"
+
+/* Defines */
+
+/*! Words in a resource bitset */
+#define RM_INDEX_RSRC_WORDS     ((SC_R_LAST + 31U) / 32U)
+
+/*! Words in a pad bitset */
+#define RM_INDEX_PAD_WORDS      ((SC_NUM_PAD + 31U) / 32U)
+
+/* Types */
+
+/*!
+ * Ownership bitsets of one partition, bit N of word N / 32 set if
+ * resource or pad N is owned
+ */
+typedef struct
+{
+    uint32_t rsrc[RM_INDEX_RSRC_WORDS];     /*!< Owned resources */
+    uint32_t pad[RM_INDEX_PAD_WORDS];       /*!< Owned pads */
+} rm_index_t;
+
+/* Functions */
+
+/*!
+ * Snapshot the resources and pads owned by a partition. RM state can
+ * change with any RPC, so the index is only valid until the next call
+ * that moves ownership.
+ *
+ * @param[in]     pt            partition
+ * @param[out]    idx           index to fill in
+ */
+void rm_index_build(sc_rm_pt_t pt, rm_index_t *idx);
+
+/*!
+ * Test if a resource is in an index.
+ *
+ * @param[in]     idx           index
+ * @param[in]     rsrc          resource
+ *
+ * @return Returns SC_TRUE if \a rsrc is owned.
+ */
+sc_bool_t rm_index_owned(const rm_index_t *idx, sc_rsrc_t rsrc);
+
+/*!
+ * Test if a pad is in an index.
+ *
+ * @param[in]     idx           index
+ * @param[in]     pad           pad
+ *
+ * @return Returns SC_TRUE if \a pad is owned.
+ */
+sc_bool_t rm_index_pad_owned(const rm_index_t *idx, sc_pad_t pad);
+
+/*!
+ * Count the resources in an index.
+ *
+ * @param[in]     idx           index
+ *
+ * @return Returns the number of owned resources.
+ */
+uint32_t rm_index_count(const rm_index_t *idx);
+
+/**@}*/
+
+#endif /* SC_RM_INDEX_H */
+
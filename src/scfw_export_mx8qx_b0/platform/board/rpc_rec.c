@@ -0,0 +1,242 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+
+
+/*==========================================================================*/
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Implementation of the board RPC flight recorder.
+ */
+/*==========================================================================*/
+
+/* Includes */
+
+#include "main/main.h"
+#include "main/board.h"
+#include "main/rpc.h"
+#include "drivers/sysctr/fsl_sysctr.h"
+#include "svc/rm/svc.h"
+#include "board/board_common.h"
+#include "board/rpc_rec.h"
+
+/* Local Defines */
+
+#define RPC_REC_MASK            (RPC_REC_DEPTH - 1U)
+
+#if (RPC_REC_DEPTH & RPC_REC_MASK) != 0U
+    #error RPC_REC_DEPTH must be a power of 2
+#endif
+
+/* Local Functions */
+
+static sc_bool_t rpc_rec_visible(sc_rm_pt_t caller_pt, sc_rm_pt_t pt);
+
+/* Local Variables */
+
+static rpc_rec_t rpc_rec_ring[RPC_REC_DEPTH];
+static uint32_t rpc_rec_seq = 0U;
+static sc_bool_t rpc_rec_enb = SC_TRUE;
+
+/* Dispatcher (resolved by the linker --wrap option) */
+
+void __real_sc_rpc_dispatch(sc_rsrc_t mu, sc_rpc_msg_t *msg);
+void __wrap_sc_rpc_dispatch(sc_rsrc_t mu, sc_rpc_msg_t *msg);
+
+/*--------------------------------------------------------------------------*/
+/* Start timing a call                                                      */
+/*--------------------------------------------------------------------------*/
+uint64_t rpc_rec_start(void)
+{
+    return board_get_counter64();
+}
+
+/*--------------------------------------------------------------------------*/
+/* Record a completed call                                                  */
+/*--------------------------------------------------------------------------*/
+void rpc_rec_log(uint64_t start, sc_rm_pt_t pt, sc_rsrc_t mu,
+    uint8_t svc, uint8_t func, sc_err_t err)
+{
+    uint64_t ticks = board_get_counter64() - start;
+
+    ENTER_CS;
+    if (rpc_rec_enb != SC_FALSE)
+    {
+        rpc_rec_t *rec = &rpc_rec_ring[rpc_rec_seq & RPC_REC_MASK];
+
+        rec->start = U32(start);
+        rec->ticks = U32(MIN(ticks, U64(UINT32_MAX)));
+        rec->mu = U16(mu);
+        rec->svc = svc;
+        rec->func = func;
+        rec->pt = U8(pt);
+        rec->err = U8(err);
+        rec->rsvd = 0U;
+        rpc_rec_seq++;
+    }
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Enable or pause recording                                                */
+/*--------------------------------------------------------------------------*/
+void rpc_rec_enable(sc_bool_t enb)
+{
+    ENTER_CS;
+    if ((enb != SC_FALSE) && (rpc_rec_enb == SC_FALSE))
+    {
+        rpc_rec_seq = 0U;
+    }
+    rpc_rec_enb = enb;
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Dump the ring                                                            */
+/*--------------------------------------------------------------------------*/
+sc_err_t rpc_rec_dump(sc_rm_pt_t caller_pt, void *buf, uint32_t *size)
+{
+    sc_err_t err = SC_ERR_NONE;
+    rpc_rec_hdr_t *hdr = (rpc_rec_hdr_t *) buf;
+    rpc_rec_t *rec = (rpc_rec_t *) &hdr[1];
+
+    if (*size < U32(sizeof(rpc_rec_hdr_t)))
+    {
+        err = SC_ERR_PARM;
+    }
+    else
+    {
+        uint32_t room = (*size - U32(sizeof(rpc_rec_hdr_t)))
+            / U32(sizeof(rpc_rec_t));
+        uint32_t count = 0U;
+        uint32_t match = 0U;
+        uint32_t skip;
+        uint32_t num;
+        uint32_t seq;
+        uint32_t idx;
+        sc_bool_t enb;
+
+        /* Pause so the ring doesn't move under the copy */
+        ENTER_CS;
+        enb = rpc_rec_enb;
+        rpc_rec_enb = SC_FALSE;
+        seq = rpc_rec_seq;
+        EXIT_CS;
+
+        /* Count the records the caller may see */
+        num = MIN(seq, RPC_REC_DEPTH);
+        for (idx = 0U; idx < num; idx++)
+        {
+            if (rpc_rec_visible(caller_pt,
+                rpc_rec_ring[(seq - num + idx) & RPC_REC_MASK].pt)
+                != SC_FALSE)
+            {
+                match++;
+            }
+        }
+
+        /* Copy the newest that fit */
+        skip = (match > room) ? (match - room) : 0U;
+        for (idx = 0U; idx < num; idx++)
+        {
+            const rpc_rec_t *src = &rpc_rec_ring[(seq - num + idx)
+                & RPC_REC_MASK];
+
+            if (rpc_rec_visible(caller_pt, src->pt) != SC_FALSE)
+            {
+                if (skip != 0U)
+                {
+                    skip--;
+                }
+                else
+                {
+                    rec[count] = *src;
+                    count++;
+                }
+            }
+        }
+
+        ENTER_CS;
+        rpc_rec_enb = enb;
+        EXIT_CS;
+
+        hdr->magic = RPC_REC_MAGIC;
+        hdr->seq = seq;
+        hdr->count = count;
+        hdr->tick_hz = U32(SYSCTR_USEC_TO_TICKS64(1000000ULL));
+        *size = U32(sizeof(rpc_rec_hdr_t)) + (count * U32(sizeof(rpc_rec_t)));
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Record an RPC dispatched from an MU, then run board RPC work             */
+/*--------------------------------------------------------------------------*/
+void __wrap_sc_rpc_dispatch(sc_rsrc_t mu, sc_rpc_msg_t *msg)
+{
+    uint8_t svc = RPC_SVC(msg);
+    uint8_t func = RPC_FUNC(msg);
+    sc_rm_pt_t pt = SC_PT;
+    uint64_t start;
+
+    /* Look up the caller first, the call may change the MU owner */
+    (void) rm_get_resource_owner(SC_PT, mu, &pt);
+
+    start = rpc_rec_start();
+    __real_sc_rpc_dispatch(mu, msg);
+    rpc_rec_log(start, pt, mu, svc, func, (sc_err_t) RPC_R8(msg));
+
+    board_rpc_work_run();
+}
+
+/*--------------------------------------------------------------------------*/
+/* Check if a caller may see a record                                       */
+/*--------------------------------------------------------------------------*/
+static sc_bool_t rpc_rec_visible(sc_rm_pt_t caller_pt, sc_rm_pt_t pt)
+{
+    sc_bool_t vis = SC_FALSE;
+
+    if ((caller_pt == SC_PT) || (caller_pt == pt)
+        || (rm_is_parent(caller_pt, pt) != SC_FALSE))
+    {
+        vis = SC_TRUE;
+    }
+
+    return vis;
+}
+
@@ -0,0 +1,147 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Header file for the board RPC flight recorder. Keeps the last calls
+ * (service, function, caller, entry time, duration and result) in a
+ * RAM ring that clients can dump. Every RPC arriving on an MU is
+ * recorded by wrapping sc_rpc_dispatch() (link with
+ * -Wl,--wrap=sc_rpc_dispatch), and each call of a board batch is
+ * recorded on its own.
+ *
+ * @addtogroup BRD_SVC (BRD) Board Interface
+ *
+ * @{
+ */
+/*==========================================================================*/
+
+#ifndef SC_RPC_REC_H
+#define SC_RPC_REC_H
+
+/* Includes */
+
+#include "main/types.h"
+#include "svc/rm/api.h"
+
+/* Defines */
+
+/*! Number of calls kept, power of 2 */
+#ifndef RPC_REC_DEPTH
+    #define RPC_REC_DEPTH       128U
+#endif
+
+/*! Dump header magic ("RREC") */
+#define RPC_REC_MAGIC           0x43455252U
+
+/* Types */
+
+/*!
+ * One recorded call
+ */
+typedef struct
+{
+    uint32_t start;         /*!< Entry time, low word of SYSCTR */
+    uint32_t ticks;         /*!< Service time in SYSCTR ticks */
+    uint16_t mu;            /*!< Caller MU resource */
+    uint8_t svc;            /*!< RPC service */
+    uint8_t func;           /*!< RPC function */
+    uint8_t pt;             /*!< Caller partition */
+    uint8_t err;            /*!< Result (sc_err_t) */
+    uint16_t rsvd;
+} rpc_rec_t;
+
+/*!
+ * Dump header, followed by \a count records oldest first
+ */
+typedef struct
+{
+    uint32_t magic;         /*!< RPC_REC_MAGIC */
+    uint32_t seq;           /*!< Calls recorded since reset */
+    uint32_t count;         /*!< Records following the header */
+    uint32_t tick_hz;       /*!< SYSCTR frequency */
+} rpc_rec_hdr_t;
+
+/* Functions */
+
+/*!
+ * Start timing a call.
+ *
+ * @return Returns the entry time to pass to rpc_rec_log().
+ */
+uint64_t rpc_rec_start(void);
+
+/*!
+ * Record a completed call.
+ *
+ * @param[in]     start         entry time from rpc_rec_start()
+ * @param[in]     pt            caller partition
+ * @param[in]     mu            caller MU resource
+ * @param[in]     svc           RPC service
+ * @param[in]     func          RPC function
+ * @param[in]     err           result
+ */
+void rpc_rec_log(uint64_t start, sc_rm_pt_t pt, sc_rsrc_t mu,
+    uint8_t svc, uint8_t func, sc_err_t err);
+
+/*!
+ * Enable or pause recording. Enabling clears the ring.
+ *
+ * @param[in]     enb           enable flag
+ */
+void rpc_rec_enable(sc_bool_t enb);
+
+/*!
+ * Dump the ring as a header and the records oldest first. Recording
+ * is paused while the dump is taken.
+ *
+ * @param[in]     caller_pt     handle of caller partition
+ * @param[out]    buf           destination
+ * @param[in,out] size          size of \a buf in bytes, returns bytes used
+ *
+ * Only calls made by \a caller_pt or its child partitions are dumped,
+ * all calls for the SC. Only the newest records that fit in \a buf are
+ * dumped.
+ *
+ * @return Returns an error code (SC_ERR_PARM if the header doesn't fit).
+ */
+sc_err_t rpc_rec_dump(sc_rm_pt_t caller_pt, void *buf, uint32_t *size);
+
+/**@}*/
+
+#endif /* SC_RPC_REC_H */
+
@@ -0,0 +1,155 @@
+/*
+** ###################################################################
+**
+**     Copyright 2018 NXP
+**
+**     Redistribution and use in source and binary forms, with or without modification,
+**     are permitted provided that the following conditions are met:
+**
+**     o Redistributions of source code must retain the above copyright notice, this list
+**       of conditions and the following disclaimer.
+**
+**     o Redistributions in binary form must reproduce the above copyright notice, this
+**       list of conditions and the following disclaimer in the documentation and/or
+**       other materials provided with the distribution.
+**
+**     o Neither the name of the copyright holder nor the names of its
+**       contributors may be used to endorse or promote products derived from this
+**       software without specific prior written permission.
+**
+**     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+**     ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+**     WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+**     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+**     ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+**     (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+**     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+**     ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+**     (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+**     SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+**
+** ###################################################################
+*/
+
+
+
+/*==========================================================================*/
+/*!
+ * @file
+ *
+ * Header file for the board XRDC shadow. Between xrdc_shadow_begin()
+ * and xrdc_shadow_commit() PDAC and MSC writes made by the RM are held
+ * in RAM and written once, in a safe order, when the window closes.
+ *
+ * The RM and XRDC driver are prebuilt, so the writes are intercepted
+ * at link time with -Wl,--wrap on the XRDC driver calls (see the board
+ * Makefile).
+ *
+ * @addtogroup BRD_SVC (BRD) Board Interface
+ *
+ * @{
+ */
+/*==========================================================================*/
+
+#ifndef SC_XRDC_SHADOW_H
+#define SC_XRDC_SHADOW_H
+
+/* Includes */
+
+#include "main/types.h"
+#include "svc/rm/api.h"
+#include "drivers/dsc/fsl_dsc.h"
+#include "drivers/xrdc2/fsl_xrdc2.h"
+
+/* Defines */
+
+/*!
+ * Number of descriptors held, must be a power of 2
+ */
+#ifndef XRDC_SHADOW_SIZE
+    #define XRDC_SHADOW_SIZE    128U
+#endif
+
+/* Types */
+
+/*!
+ * Shadow statistics
+ */
+typedef struct
+{
+    uint32_t captured;      /*!< Descriptor writes held in the shadow */
+    uint32_t written;       /*!< Descriptor writes made on commit */
+    uint32_t skipped;       /*!< Descriptors already set in hardware */
+    uint32_t multi;         /*!< Runs written with one SetMulti call */
+    uint32_t commits;       /*!< Flushes of the shadow */
+    uint32_t early;         /*!< Flushes forced by MDA/MRC writes or
+                                 a full slot */
+} xrdc_shadow_stats_t;
+
+/* Functions */
+
+/*!
+ * Open a shadow window. Windows nest, only the outermost commit
+ * flushes.
+ *
+ * Only open a window around RM calls. Power transitions in a window
+ * could leave the flush writing to a powered down subsystem.
+ */
+void xrdc_shadow_begin(void);
+
+/*!
+ * Close a shadow window. The outermost commit writes the held
+ * descriptors that differ from the hardware. Descriptors that only
+ * remove access are written first, then the rest. Consecutive
+ * descriptors with the same value use one SetMulti call.
+ */
+void xrdc_shadow_commit(void);
+
+/*!
+ * Get the shadow statistics.
+ *
+ * @param[out]    stats         statistics to fill in
+ */
+void xrdc_shadow_get_stats(xrdc_shadow_stats_t *stats);
+
+/*!
+ * @name Link-time wrappers
+ * Called in place of the XRDC driver functions of the same name.
+ * @{
+ */
+
+void __wrap_XRDC_Init(sc_dsc_t dsc);
+sc_bool_t __wrap_XRDC_Config(sc_dsc_t dsc, sc_bool_t mst_enable,
+    sc_bool_t chk_enable);
+void __wrap_XRDC_GetMsc(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms);
+void __wrap_XRDC_SetMsc(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, const xrdc_perm_t *perms);
+void __wrap_XRDC_SetMultiMsc(sc_dsc_t dsc, xrdc_idx_t start,
+    xrdc_idx_t num, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms);
+void __wrap_XRDC_SetMda(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, sc_rm_spa_t sa, sc_rm_spa_t pa, xrdc_did_t did,
+    xrdc_sid_t sid, xrdc_match_t match, xrdc_match_t mask,
+    sc_bool_t has_match, uint32_t *cache);
+void __wrap_XRDC_GetPdac(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t *valid,
+    sc_bool_t *lock, xrdc_perm_t *perms);
+void __wrap_XRDC_SetPdac(sc_dsc_t dsc, xrdc_idx_t idx, sc_bool_t valid,
+    sc_bool_t lock, const xrdc_perm_t *perms, sc_bool_t no_update);
+void __wrap_XRDC_SetMultiPdac(sc_dsc_t dsc, xrdc_idx_t start,
+    xrdc_idx_t num, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms, sc_bool_t no_update);
+void __wrap_XRDC_SetMrc(sc_dsc_t dsc, xrdc_idx_t idx, sc_faddr_t start,
+    sc_faddr_t end, sc_bool_t valid, sc_bool_t lock,
+    const xrdc_perm_t *perms, xrdc_det_t det, xrdc_rmsg_t rmsg,
+    uint32_t *cache);
+void __wrap_XRDC_InvalidateMrc(sc_dsc_t dsc, xrdc_idx_t idx,
+    xrdc_idx_t regions, uint32_t *cache);
+
+/* @} */
+
+/**@}*/
+
+#endif /* SC_XRDC_SHADOW_H */
+
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2017-2019 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Includes */
+
+#include "main/scfw.h"
+#include "main/main.h"
+#include "main/sched.h"
+#include "fsl_device_registers.h"
+#include "drivers/pmic/fsl_i2c_queue.h"
+#include "drivers/lpi2c/fsl_lpi2c.h"
+#include "fsl_common.h"
+
+/* Local Functions */
+
+static sc_bool_t i2c_queue_can_sleep(void);
+static void i2c_queue_start(void);
+static void i2c_queue_complete(status_t status);
+static void i2c_queue_callback(LPI2C_Type *base,
+    lpi2c_master_handle_t *handle, status_t completionStatus,
+    void *userData);
+
+/* Local Variables */
+
+static lpi2c_master_handle_t i2c_queue_handle;
+static i2c_queue_xfer_t *i2c_queue_head;
+static i2c_queue_xfer_t *i2c_queue_tail;
+static volatile sc_bool_t i2c_queue_busy;
+static sc_bool_t i2c_queue_ready;
+
+/*--------------------------------------------------------------------------*/
+/* Init the transaction queue                                               */
+/*--------------------------------------------------------------------------*/
+void i2c_queue_init(void)
+{
+    if (i2c_queue_ready == SC_FALSE)
+    {
+        i2c_queue_head = NULL;
+        i2c_queue_tail = NULL;
+        i2c_queue_busy = SC_FALSE;
+
+        LPI2C_MasterTransferCreateHandle(LPI2C_PMIC, &i2c_queue_handle,
+            i2c_queue_callback, NULL);
+
+        NVIC_SetPriority(I2C_QUEUE_IRQn, U32(I2C_QUEUE_IRQ_PRIO));
+        NVIC_EnableIRQ(I2C_QUEUE_IRQn);
+
+        i2c_queue_ready = SC_TRUE;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Return if the queue is in use                                            */
+/*--------------------------------------------------------------------------*/
+sc_bool_t i2c_queue_active(void)
+{
+    return i2c_queue_ready;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Fill in a register access descriptor                                     */
+/*--------------------------------------------------------------------------*/
+void i2c_queue_xfer_init(i2c_queue_xfer_t *xfer, uint8_t device_addr,
+    uint8_t reg, lpi2c_direction_t dir, void *data, uint32_t dataLength,
+    i2c_queue_callback_t callback, void *userData)
+{
+    xfer->next = NULL;
+    xfer->xfer.flags = U32(kLPI2C_TransferDefaultFlag);
+    xfer->xfer.slaveAddress = U16(device_addr);
+    xfer->xfer.direction = dir;
+    xfer->xfer.subaddress = U32(reg);
+    xfer->xfer.subaddressSize = 1U;
+    xfer->xfer.data = data;
+    xfer->xfer.dataSize = dataLength;
+    xfer->callback = callback;
+    xfer->userData = userData;
+    xfer->status = I32(kStatus_LPI2C_Busy);
+    xfer->done = SC_FALSE;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Queue a transaction                                                      */
+/*--------------------------------------------------------------------------*/
+status_t i2c_queue_submit(i2c_queue_xfer_t *xfer)
+{
+    status_t status = I32(kStatus_Success);
+
+    if (i2c_queue_ready == SC_FALSE)
+    {
+        status = I32(kStatus_Fail);
+    }
+    else
+    {
+        xfer->next = NULL;
+        xfer->status = I32(kStatus_LPI2C_Busy);
+        xfer->done = SC_FALSE;
+
+        ENTER_CS;
+
+        if (i2c_queue_tail == NULL)
+        {
+            i2c_queue_head = xfer;
+        }
+        else
+        {
+            i2c_queue_tail->next = xfer;
+        }
+        i2c_queue_tail = xfer;
+
+        /* Kick the bus if idle, otherwise the IRQ picks it up */
+        i2c_queue_start();
+
+        EXIT_CS;
+    }
+
+    return status;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Wait for a transaction to complete                                       */
+/*--------------------------------------------------------------------------*/
+status_t i2c_queue_wait(i2c_queue_xfer_t *xfer)
+{
+    while (xfer->done == SC_FALSE)
+    {
+        if (i2c_queue_can_sleep() != SC_FALSE)
+        {
+            #ifndef SIMU
+                /* Sleep until the next interrupt, masked so an LPI2C
+                   completion between the check and the WFI still wakes */
+                __disable_irq();
+                if (xfer->done == SC_FALSE)
+                {
+                    __WFI();
+                }
+                __enable_irq();
+            #endif
+        }
+        else
+        {
+            /* Service the LPI2C inline if the caller runs at or above the
+               priority of its IRQ (or with interrupts masked) */
+            ENTER_CS;
+            if (NVIC_GetPendingIRQ(I2C_QUEUE_IRQn) != 0U)
+            {
+                NVIC_ClearPendingIRQ(I2C_QUEUE_IRQn);
+                LPI2C_MasterTransferHandleIRQ(LPI2C_PMIC, &i2c_queue_handle);
+            }
+            EXIT_CS;
+        }
+    }
+
+    return xfer->status;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Queue a register write and wait                                          */
+/*--------------------------------------------------------------------------*/
+status_t i2c_queue_write(uint8_t device_addr, uint8_t reg, const void *data,
+    uint32_t dataLength)
+{
+    i2c_queue_xfer_t xfer;
+    status_t status;
+
+    /* The descriptor is shared with reads, data is only read from */
+    i2c_queue_xfer_init(&xfer, device_addr, reg, kLPI2C_Write,
+        (void *) (uintptr_t) data, dataLength, NULL, NULL);
+
+    status = i2c_queue_submit(&xfer);
+    if (status == I32(kStatus_Success))
+    {
+        status = i2c_queue_wait(&xfer);
+    }
+
+    return status;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Queue a register read and wait                                           */
+/*--------------------------------------------------------------------------*/
+status_t i2c_queue_read(uint8_t device_addr, uint8_t reg, void *data,
+    uint32_t dataLength)
+{
+    i2c_queue_xfer_t xfer;
+    status_t status;
+
+    i2c_queue_xfer_init(&xfer, device_addr, reg, kLPI2C_Read, data,
+        dataLength, NULL, NULL);
+
+    status = i2c_queue_submit(&xfer);
+    if (status == I32(kStatus_Success))
+    {
+        status = i2c_queue_wait(&xfer);
+    }
+
+    return status;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Service the LPI2C interrupt                                              */
+/*--------------------------------------------------------------------------*/
+void i2c_queue_irq_handler(void)
+{
+    LPI2C_MasterTransferHandleIRQ(LPI2C_PMIC, &i2c_queue_handle);
+}
+
+/*==========================================================================*/
+
+/*--------------------------------------------------------------------------*/
+/* Return if the LPI2C IRQ can preempt the caller                           */
+/*--------------------------------------------------------------------------*/
+static sc_bool_t i2c_queue_can_sleep(void)
+{
+    sc_bool_t rtn = SC_FALSE;
+
+    #ifndef SIMU
+        uint32_t prio = U32(I2C_QUEUE_IRQ_PRIO);
+        uint32_t basepri = __get_BASEPRI() >> (8U - __NVIC_PRIO_BITS);
+        uint32_t ipsr = __get_IPSR();
+
+        /* Lower numbers are higher priority, NMI and HardFault are fixed */
+        if ((__get_PRIMASK() == 0U) && ((basepri == 0U) || (basepri > prio)))
+        {
+            if (ipsr == 0U)
+            {
+                rtn = SC_TRUE;
+            }
+            else if ((ipsr > 3U)
+                && (NVIC_GetPriority((IRQn_Type) (I32(ipsr) - 16)) > prio))
+            {
+                rtn = SC_TRUE;
+            }
+            else
+            {
+                ; /* Intentional empty else */
+            }
+        }
+    #endif
+
+    return rtn;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Start the transaction at the head of the queue                           */
+/*--------------------------------------------------------------------------*/
+static void i2c_queue_start(void)
+{
+    /* Must be called with the queue locked or from the LPI2C IRQ */
+    while ((i2c_queue_busy == SC_FALSE) && (i2c_queue_head != NULL))
+    {
+        status_t status = LPI2C_MasterTransferNonBlocking(LPI2C_PMIC,
+            &i2c_queue_handle, &i2c_queue_head->xfer);
+
+        if (status == I32(kStatus_Success))
+        {
+            i2c_queue_busy = SC_TRUE;
+        }
+        else
+        {
+            /* Fail this one and move on to the next */
+            i2c_queue_complete(status);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Retire the transaction at the head of the queue                          */
+/*--------------------------------------------------------------------------*/
+static void i2c_queue_complete(status_t status)
+{
+    i2c_queue_xfer_t *xfer = i2c_queue_head;
+
+    if (xfer != NULL)
+    {
+        i2c_queue_callback_t callback = xfer->callback;
+        void *userData = xfer->userData;
+
+        i2c_queue_head = xfer->next;
+        if (i2c_queue_head == NULL)
+        {
+            i2c_queue_tail = NULL;
+        }
+
+        /* A synchronous waiter may release the descriptor once done is
+           set, so nothing in it can be touched afterwards */
+        xfer->status = status;
+        xfer->done = SC_TRUE;
+
+        if (callback != NULL)
+        {
+            callback(status, userData);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* LPI2C driver completion callback                                         */
+/*--------------------------------------------------------------------------*/
+static void i2c_queue_callback(LPI2C_Type *base,
+    lpi2c_master_handle_t *handle, status_t completionStatus,
+    void *userData)
+{
+    i2c_queue_busy = SC_FALSE;
+
+    i2c_queue_complete(completionStatus);
+    i2c_queue_start();
+}
+
+/**@}*/
+
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2017-2019 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Includes */
+
+#include "main/scfw.h"
+#include "main/main.h"
+#include "drivers/pmic/fsl_pmic.h"
+#include "drivers/pmic/fsl_pmic_shadow.h"
+
+/* Local Defines */
+
+#define PMIC_SHADOW_REGS    256U
+#define PMIC_SHADOW_WORDS   (PMIC_SHADOW_REGS / 32U)
+
+/* Local Types */
+
+/*!
+ * Shadow of one PMIC register space
+ */
+typedef struct
+{
+    pmic_id_t id;                               /*!< I2C address (0 = free) */
+    uint32_t valid[PMIC_SHADOW_WORDS];          /*!< Valid bitmap */
+    uint8_t val[PMIC_SHADOW_REGS];              /*!< Register values */
+} pmic_shadow_t;
+
+/* Local Functions */
+
+static pmic_shadow_t *pmic_shadow_find(pmic_id_t id, sc_bool_t alloc);
+
+/* Local Variables */
+
+static pmic_shadow_t pmic_shadow[PMIC_SHADOW_NUM_DEV];
+static pmic_shadow_stats_t pmic_shadow_stats;
+
+/*--------------------------------------------------------------------------*/
+/* Look up a shadowed register                                              */
+/*--------------------------------------------------------------------------*/
+sc_bool_t pmic_shadow_get(pmic_id_t id, uint8_t reg, uint8_t *val)
+{
+    const pmic_shadow_t *sh = pmic_shadow_find(id, SC_FALSE);
+    sc_bool_t hit = SC_FALSE;
+
+    ENTER_CS;
+    if ((sh != NULL) && ((sh->valid[reg / 32U] & BIT32(reg)) != 0U))
+    {
+        *val = sh->val[reg];
+        hit = SC_TRUE;
+        pmic_shadow_stats.hits++;
+    }
+    else
+    {
+        pmic_shadow_stats.misses++;
+    }
+    EXIT_CS;
+
+    return hit;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Record a register value                                                  */
+/*--------------------------------------------------------------------------*/
+void pmic_shadow_update(pmic_id_t id, uint8_t reg, uint8_t val)
+{
+    pmic_shadow_t *sh = pmic_shadow_find(id, SC_TRUE);
+
+    if (sh != NULL)
+    {
+        ENTER_CS;
+        sh->val[reg] = val;
+        sh->valid[reg / 32U] |= BIT32(reg);
+        EXIT_CS;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Check if a write would not change the register                           */
+/*--------------------------------------------------------------------------*/
+sc_bool_t pmic_shadow_current(pmic_id_t id, uint8_t reg, uint8_t val)
+{
+    const pmic_shadow_t *sh = pmic_shadow_find(id, SC_FALSE);
+    sc_bool_t current = SC_FALSE;
+
+    ENTER_CS;
+    if ((sh != NULL) && ((sh->valid[reg / 32U] & BIT32(reg)) != 0U)
+        && (sh->val[reg] == val))
+    {
+        current = SC_TRUE;
+        pmic_shadow_stats.skips++;
+    }
+    else
+    {
+        pmic_shadow_stats.writes++;
+    }
+    EXIT_CS;
+
+    return current;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Drop one shadowed register                                               */
+/*--------------------------------------------------------------------------*/
+void pmic_shadow_invalidate(pmic_id_t id, uint8_t reg)
+{
+    pmic_shadow_t *sh = pmic_shadow_find(id, SC_FALSE);
+
+    if (sh != NULL)
+    {
+        ENTER_CS;
+        sh->valid[reg / 32U] &= ~BIT32(reg);
+        EXIT_CS;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Drop a range of shadowed registers                                       */
+/*--------------------------------------------------------------------------*/
+void pmic_shadow_invalidate_range(pmic_id_t id, uint8_t first, uint8_t last)
+{
+    pmic_shadow_t *sh = pmic_shadow_find(id, SC_FALSE);
+    uint32_t reg;
+
+    if (sh != NULL)
+    {
+        ENTER_CS;
+        for (reg = U32(first); reg <= U32(last); reg++)
+        {
+            sh->valid[reg / 32U] &= ~BIT32(reg);
+        }
+        EXIT_CS;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Drop all shadowed registers of a PMIC                                    */
+/*--------------------------------------------------------------------------*/
+void pmic_shadow_invalidate_all(pmic_id_t id)
+{
+    pmic_shadow_t *sh = pmic_shadow_find(id, SC_FALSE);
+    uint32_t i;
+
+    if (sh != NULL)
+    {
+        ENTER_CS;
+        for (i = 0U; i < PMIC_SHADOW_WORDS; i++)
+        {
+            sh->valid[i] = 0U;
+        }
+        EXIT_CS;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Return shadow statistics                                                 */
+/*--------------------------------------------------------------------------*/
+void pmic_shadow_get_stats(pmic_shadow_stats_t *stats)
+{
+    ENTER_CS;
+    *stats = pmic_shadow_stats;
+    EXIT_CS;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Find (or allocate) the shadow for a PMIC                                 */
+/*--------------------------------------------------------------------------*/
+static pmic_shadow_t *pmic_shadow_find(pmic_id_t id, sc_bool_t alloc)
+{
+    pmic_shadow_t *sh = NULL;
+    uint32_t i;
+
+    /* Address 0 marks a free slot */
+    if (id != 0U)
+    {
+        ENTER_CS;
+        for (i = 0U; i < PMIC_SHADOW_NUM_DEV; i++)
+        {
+            if (pmic_shadow[i].id == id)
+            {
+                sh = &pmic_shadow[i];
+                break;
+            }
+        }
+
+        /* Claim a free slot, all registers start invalid */
+        if ((sh == NULL) && (alloc != SC_FALSE))
+        {
+            for (i = 0U; i < PMIC_SHADOW_NUM_DEV; i++)
+            {
+                if (pmic_shadow[i].id == 0U)
+                {
+                    sh = &pmic_shadow[i];
+                    sh->id = id;
+                    break;
+                }
+            }
+        }
+        EXIT_CS;
+    }
+
+    return sh;
+}
+
+/**@}*/
+
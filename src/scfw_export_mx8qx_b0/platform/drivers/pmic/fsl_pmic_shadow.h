@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2017-2019 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DRV_PMIC_SHADOW_H
+#define DRV_PMIC_SHADOW_H
+
+/*!
+ * @addtogroup pmic_driver
+ * @{
+ */
+
+/*! @file */
+
+/* Includes */
+
+#include "main/types.h"
+#include "drivers/pmic/fsl_pmic.h"
+
+/* Defines */
+
+/*! Number of PMIC devices that can be shadowed */
+#ifndef PMIC_SHADOW_NUM_DEV
+    #define PMIC_SHADOW_NUM_DEV     3U
+#endif
+
+/* Types */
+
+/*!
+ * Shadow statistics
+ */
+typedef struct
+{
+    uint32_t hits;          /*!< Register reads served from the shadow */
+    uint32_t misses;        /*!< Register reads that went to the PMIC */
+    uint32_t skips;         /*!< Register writes dropped as already current */
+    uint32_t writes;        /*!< Register writes sent to the PMIC */
+} pmic_shadow_stats_t;
+
+/* Functions */
+
+/*!
+ * This function looks up a register in the shadow.
+ *
+ * @param[in]       id              I2C address of PMIC device
+ * @param[in]       reg             address of register on device
+ * @param[out]      val             shadowed value
+ *
+ * @return Returns SC_TRUE if the shadow held a valid copy
+ */
+sc_bool_t pmic_shadow_get(pmic_id_t id, uint8_t reg, uint8_t *val);
+
+/*!
+ * This function records a value read from or written to the PMIC.
+ *
+ * @param[in]       id              I2C address of PMIC device
+ * @param[in]       reg             address of register on device
+ * @param[in]       val             value now in the register
+ */
+void pmic_shadow_update(pmic_id_t id, uint8_t reg, uint8_t val);
+
+/*!
+ * This function checks if a write can be skipped because the register
+ * already holds the value. Counts the write as sent or skipped.
+ *
+ * @param[in]       id              I2C address of PMIC device
+ * @param[in]       reg             address of register on device
+ * @param[in]       val             value to be written
+ *
+ * @return Returns SC_TRUE if the shadow holds the same value
+ */
+sc_bool_t pmic_shadow_current(pmic_id_t id, uint8_t reg, uint8_t val);
+
+/*!
+ * This function drops the shadow copy of one register.
+ *
+ * @param[in]       id              I2C address of PMIC device
+ * @param[in]       reg             address of register on device
+ */
+void pmic_shadow_invalidate(pmic_id_t id, uint8_t reg);
+
+/*!
+ * This function drops the shadow copies of a range of registers. Used
+ * when a page select changes what the range maps to.
+ *
+ * @param[in]       id              I2C address of PMIC device
+ * @param[in]       first           first register to drop
+ * @param[in]       last            last register to drop
+ */
+void pmic_shadow_invalidate_range(pmic_id_t id, uint8_t first, uint8_t last);
+
+/*!
+ * This function drops all shadowed registers of a PMIC. Used when the
+ * PMIC may have changed state on its own (e.g. after an interrupt).
+ *
+ * @param[in]       id              I2C address of PMIC device
+ */
+void pmic_shadow_invalidate_all(pmic_id_t id);
+
+/*!
+ * This function returns the shadow statistics.
+ *
+ * @param[out]      stats           statistics to fill in
+ */
+void pmic_shadow_get_stats(pmic_shadow_stats_t *stats);
+
+#endif
+
+/**@}*/
+
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2017-2019 NXP
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DRV_PMIC_VCODEC_H
+#define DRV_PMIC_VCODEC_H
+
+/*!
+ * @addtogroup pmic_driver
+ * @{
+ */
+
+/*! @file */
+
+/* Includes */
+
+#include "main/types.h"
+
+/* Defines */
+
+/*! Max number of codes in a voltage table */
+#define PMIC_VCODEC_MAX     32U
+
+/* Types */
+
+/*!
+ * Voltage codec for a regulator with a table of setpoints. Built once
+ * from a code-indexed table, it keeps the codes ordered by voltage so
+ * encoding is a binary search instead of a scan.
+ */
+typedef struct
+{
+    const uint32_t *mv;                 /*!< Voltage in mV by code */
+    uint8_t num;                        /*!< Number of codes */
+    uint8_t order[PMIC_VCODEC_MAX];     /*!< Codes sorted by voltage */
+} pmic_vcodec_t;
+
+/* Functions */
+
+/*!
+ * This function builds a codec from a code-indexed voltage table.
+ *
+ * @param[out]      codec           codec to build
+ * @param[in]       mv              voltage in mV of each code
+ * @param[in]       num             number of codes (max PMIC_VCODEC_MAX)
+ *
+ * Codes with the same voltage stay in code order, so encoding always
+ * returns the lowest code, as a scan from code 0 would.
+ */
+void pmic_vcodec_init(pmic_vcodec_t *codec, const uint32_t *mv,
+    uint8_t num);
+
+/*!
+ * This function returns the voltage of a code.
+ *
+ * @param[in]       codec           codec
+ * @param[in]       code            register code
+ *
+ * @return Returns the voltage in mV, 0 if \a code is out of range
+ */
+uint32_t pmic_vcodec_decode(const pmic_vcodec_t *codec, uint8_t code);
+
+/*!
+ * This function finds the code of an exact voltage.
+ *
+ * @param[in]       codec           codec
+ * @param[in]       vol_mv          voltage in mV
+ * @param[out]      code            lowest code with that voltage
+ *
+ * @return Returns SC_TRUE if the voltage is in the table
+ */
+sc_bool_t pmic_vcodec_find(const pmic_vcodec_t *codec, uint32_t vol_mv,
+    uint8_t *code);
+
+/*!
+ * This function finds the code of the lowest voltage at or above a
+ * requested voltage.
+ *
+ * @param[in]       codec           codec
+ * @param[in]       vol_mv          voltage in mV
+ * @param[out]      code            lowest code with that voltage
+ *
+ * @return Returns SC_TRUE if a voltage at or above \a vol_mv exists
+ */
+sc_bool_t pmic_vcodec_ceil(const pmic_vcodec_t *codec, uint32_t vol_mv,
+    uint8_t *code);
+
+#endif
+
+/**@}*/
+
@@ -34,6 +34,8 @@
 #include "main/main.h"
 #include "fsl_device_registers.h"
 #include "drivers/pmic/fsl_pmic.h"
+#include "drivers/pmic/fsl_pmic_shadow.h"
+#include "drivers/pmic/fsl_pmic_vcodec.h"
 #include "drivers/lpi2c/fsl_lpi2c.h"
 #include "drivers/pmic/pf8100/fsl_pf8100.h"
 #include "fsl_common.h"
@@ -54,9 +56,15 @@
 #define B0_SI_REV           0x20U
 #define C0_SI_REV           0x30U
 
+/*! Registers below this hold IDs, interrupt latches and sense bits */
+#define PF8100_SHADOW_START 0x35U
+
 /* Local Functions */
 
 static inline sc_err_t check_si_rev(uint8_t address);
+static void pf8100_codec_init(void);
+static status_t pf8100_reg_read(pmic_id_t id, uint8_t reg, uint8_t *val);
+static status_t pf8100_reg_write(pmic_id_t id, uint8_t reg, uint8_t val);
 
 /* Local Variables */
 
@@ -66,6 +74,10 @@ static inline sc_err_t check_si_rev(uint8_t address);
  * 0x01 is B0     */
 static volatile uint8_t si_rev = NOT_DETECTED;
 
+/* Voltage codecs, built when the silicon revision is known */
+static pmic_vcodec_t sw7_codec;
+static pmic_vcodec_t ldo_codec;
+
 /*!
  * Defines for pf8100_ctl_regs_t
  */
@@ -75,6 +87,10 @@ static volatile uint8_t si_rev = NOT_DETECTED;
 #define PF8100_THERMINT         0x07U
 #define PF8100_THERMMASK        0x08U
 #define PF8100_THERMSENSE       0x09U
+#define PF8100_SW_UV_SENSE      0x1AU
+#define PF8100_SW_OV_SENSE      0x1DU
+#define PF8100_LDO_UV_SENSE     0x20U
+#define PF8100_LDO_OV_SENSE     0x23U
 #define PF8100_VMONEN1          0x35U
 #define PF8100_VMONEN2          0x36U
 #define PF8100_CTRL1            0x37U
@@ -264,6 +280,7 @@ pmic_version_t pf8100_get_pmic_version(pmic_id_t id)
     if(ver.si_rev != 0U)
     {
         si_rev = ver.si_rev;
+        pf8100_codec_init();
     }
 
     return ver;
@@ -277,7 +294,6 @@ sc_err_t pf8100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
 {
     sc_err_t rtn = SC_ERR_NONE;
     uint8_t val = 0U;
-    const uint32_t *ldo_lookup = ldo_table;
     uint8_t pmic_reg8;
 
     if (pmic_reg >= 0x100U)
@@ -294,15 +310,6 @@ sc_err_t pf8100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
         return SC_ERR_FAIL;
     }
 
-    if(si_rev == A0_SI_REV)
-    {
-      ldo_lookup = ldo_table_a0;
-    }
-    else if ((si_rev == B0_SI_REV) || (si_rev == C0_SI_REV))
-    {
-        ldo_lookup = ldo_table_b0;
-    }
-
     switch (pmic_reg8)
     {
         case PF8100_SW1:
@@ -333,12 +340,8 @@ sc_err_t pf8100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
             {
                 return SC_ERR_PARM;
             }
-            /* use lookup table to get near requested V */
-            val = 0U;
-            while ((val < 32U) && (sw7v_lookup[val] < vol_mv))
-            {
-                val++;
-            }
+            /* lowest setpoint at or above the requested V */
+            (void) pmic_vcodec_ceil(&sw7_codec, vol_mv, &val);
             pmic_reg8 = pmic_reg8 + sw_run_volt;
             break;
         case PF8100_LDO1:
@@ -349,13 +352,7 @@ sc_err_t pf8100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
             {
                 return SC_ERR_PARM;
             }
-            /* use lookup table to step through possible voltages */
-            val = 0U;
-            for (val = 0U; val < 16U; val ++)
-            {
-               if (ldo_lookup[val] == vol_mv) break;
-            }
-            if (val == 16U)
+            if (pmic_vcodec_find(&ldo_codec, vol_mv, &val) == SC_FALSE)
             {
                 /* Return unavaliable if not found in LDO values */
                 return SC_ERR_UNAVAILABLE;
@@ -372,7 +369,7 @@ sc_err_t pf8100_pmic_set_voltage(pmic_id_t id, uint32_t pmic_reg,
     {
         status_t err;
 
-        err = I2C_WRITE(id, pmic_reg8, &val, 1);
+        err = pf8100_reg_write(id, pmic_reg8, val);
         if (err != (status_t) kStatus_Success)
         {
             error_print("pmic_set_voltage - Failed to set voltage for PMIC %d, reg %u\n",
@@ -394,7 +391,6 @@ sc_err_t pf8100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
     status_t err;
     uint32_t pmic_reg_base = pmic_reg;
     uint8_t val = 0U;
-    const uint32_t *ldo_lookup = ldo_table;
     uint8_t pmic_reg8;
 
     if (pmic_reg >= 0x100U)
@@ -411,15 +407,6 @@ sc_err_t pf8100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
         return SC_ERR_FAIL;
     }
 
-    if (si_rev == A0_SI_REV)
-    {
-        ldo_lookup = ldo_table_a0;
-    }
-    else if ((si_rev == B0_SI_REV) || (si_rev == C0_SI_REV))
-    {
-        ldo_lookup = ldo_table_b0;
-    }
-
     switch (pmic_reg8)
     {
         case PF8100_SW1:
@@ -452,7 +439,7 @@ sc_err_t pf8100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
     if (rtn == SC_ERR_NONE)
     {
         /* Read voltage value from PMIC */ 
-        err = I2C_READ(id, pmic_reg8, &val, 1U);
+        err = pf8100_reg_read(id, pmic_reg8, &val);
         if (err != (status_t) kStatus_Success)
         {
             error_print("pmic_get_voltage - Failed to get voltage for PMIC %d, reg %u\n",
@@ -481,14 +468,14 @@ sc_err_t pf8100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
                     break;
                 case PF8100_SW7:
                     /* Obtain voltage from sw7 lookup table */
-                    *vol_mv = sw7v_lookup[val];
+                    *vol_mv = pmic_vcodec_decode(&sw7_codec, val);
                     break;
                 case PF8100_LDO1:
                 case PF8100_LDO2:
                 case PF8100_LDO3:
                 case PF8100_LDO4:
                     /* Obtain voltage from LDO lookup table */
-                    *vol_mv = ldo_lookup[val];
+                    *vol_mv = pmic_vcodec_decode(&ldo_codec, val);
                     break;
                 default:
                     ; /* Intentional empty default */
@@ -506,7 +493,7 @@ sc_err_t pf8100_pmic_get_voltage(pmic_id_t id, uint32_t pmic_reg,
 sc_err_t pf8100_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
 {
     sc_err_t rtn = SC_ERR_NONE;
-    uint32_t val = 0U;
+    uint8_t val = 0U;
     uint8_t pmic_reg8;
 
     if (pmic_reg >= 0x100U)
@@ -544,7 +531,7 @@ sc_err_t pf8100_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
     {
         status_t err;
 
-        err = I2C_READ(id, pmic_reg8, &val, 1U);
+        err = pf8100_reg_read(id, pmic_reg8, &val);
         if (err != (status_t) kStatus_Success)
         {
             error_print("pmic_set_mode - Failed to read for PMIC %d, reg %u\n",
@@ -553,10 +540,10 @@ sc_err_t pf8100_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
             return SC_ERR_FAIL;
         }
 
-        val &= ~MODE_MASK;
-        val |= mode & MODE_MASK;
+        val &= U8(~MODE_MASK);
+        val |= U8(mode & MODE_MASK);
         
-        err = I2C_WRITE(id, pmic_reg8, &val, 1U);
+        err = pf8100_reg_write(id, pmic_reg8, val);
         if (err != (status_t) kStatus_Success)
         {
             error_print("pmic_set_mode - Failed to set mode to %u for PMIC %d, reg %u\n",
@@ -575,7 +562,7 @@ sc_err_t pf8100_pmic_set_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t mode)
 sc_err_t pf8100_pmic_get_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t *mode)
 {
     sc_err_t rtn = SC_ERR_NONE;
-    uint32_t val = 0U;
+    uint8_t val = 0U;
     uint8_t pmic_reg8;
 
     if (pmic_reg >= 0x100U)
@@ -613,7 +600,7 @@ sc_err_t pf8100_pmic_get_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t *mode)
     {
         status_t err;
 
-        err = I2C_READ(id, pmic_reg8, &val, 1U);
+        err = pf8100_reg_read(id, pmic_reg8, &val);
         if (err != (status_t) kStatus_Success)
         {
             error_print("pmic_get_mode - Failed to read for PMIC %d, reg %u\n",
@@ -622,8 +609,7 @@ sc_err_t pf8100_pmic_get_mode(pmic_id_t id, uint32_t pmic_reg, uint32_t *mode)
             return SC_ERR_FAIL;
         }
 
-        val &= MODE_MASK;
-        *mode = val;
+        *mode = U32(val) & MODE_MASK;
     }
 
     return rtn;
@@ -638,11 +624,11 @@ uint32_t pf8100_get_pmic_temp(pmic_id_t id)
     uint8_t sense = 0U, reg = 0U;
 
     /* Enabled monitor if off */
-    (void) I2C_READ(id, PF8100_CTRL1, &reg, 1U);
+    (void) pf8100_reg_read(id, PF8100_CTRL1, &reg);
     if((reg & TMP_MON_EN_MSK) == 0U)
     {
         reg |= TMP_MON_EN_MSK;
-        (void) I2C_WRITE(id, PF8100_CTRL1, &reg, 1U);
+        (void) pf8100_reg_write(id, PF8100_CTRL1, reg);
     }
 
     (void) I2C_READ(id, PF8100_THERMSENSE, &sense, 1U);
@@ -700,11 +686,11 @@ uint32_t pf8100_set_pmic_temp_alarm(pmic_id_t id, uint32_t temp)
     (void) I2C_WRITE(id, PF8100_THERMMASK, &reg, 1U);
     
     /* Enabled monitor if off */
-    (void) I2C_READ(id, PF8100_CTRL1, &reg, 1U);
+    (void) pf8100_reg_read(id, PF8100_CTRL1, &reg);
     if((reg & TMP_MON_EN_MSK) == 0U)
     {
         reg |= TMP_MON_EN_MSK;
-        (void) I2C_WRITE(id, PF8100_CTRL1, &reg, 1U);
+        (void) pf8100_reg_write(id, PF8100_CTRL1, reg);
     }
 
     return temp;
@@ -720,7 +706,7 @@ sc_err_t pf8100_pmic_register_access(pmic_id_t id, uint32_t address,
 
     if (read_write == SC_FALSE)
     {
-        err = I2C_READ(id, U8(address), value, 1U);
+        err = pf8100_reg_read(id, U8(address), value);
         if (err != (status_t) kStatus_Success)
         {
             error_print("PMIC register access - Failed to read for PMIC at: %x, reg %x\n",
@@ -731,7 +717,9 @@ sc_err_t pf8100_pmic_register_access(pmic_id_t id, uint32_t address,
     }
     else
     {
+        /* Raw write, the register may not read back as written */
         err = I2C_WRITE(id, U8(address), value, 1U);
+        pmic_shadow_invalidate(id, U8(address));
         if (err != (status_t) kStatus_Success)
         {
             error_print("PMIC register access - Failed to write for PMIC at: %x, reg %x\n",
@@ -744,6 +732,49 @@ sc_err_t pf8100_pmic_register_access(pmic_id_t id, uint32_t address,
     return SC_ERR_NONE;
 }
 
+/*--------------------------------------------------------------------------*/
+/* Get PMIC Regulator Power Good                                            */
+/*--------------------------------------------------------------------------*/
+sc_err_t pf8100_pmic_get_pg(pmic_id_t id, uint32_t pmic_reg, sc_bool_t *pg)
+{
+    uint8_t uv_reg;
+    uint8_t ov_reg;
+    uint8_t bit;
+    uint8_t uv = 0U;
+    uint8_t ov = 0U;
+
+    /* Sense registers hold one bit per regulator */
+    if ((pmic_reg >= PF8100_SW1) && (pmic_reg <= PF8100_SW7)
+        && (((pmic_reg - PF8100_SW1) % 8U) == 0U))
+    {
+        uv_reg = PF8100_SW_UV_SENSE;
+        ov_reg = PF8100_SW_OV_SENSE;
+        bit = U8((pmic_reg - PF8100_SW1) / 8U);
+    }
+    else if ((pmic_reg >= PF8100_LDO1) && (pmic_reg <= PF8100_LDO4)
+        && (((pmic_reg - PF8100_LDO1) % 6U) == 0U))
+    {
+        uv_reg = PF8100_LDO_UV_SENSE;
+        ov_reg = PF8100_LDO_OV_SENSE;
+        bit = U8((pmic_reg - PF8100_LDO1) / 6U);
+    }
+    else
+    {
+        return SC_ERR_PARM;
+    }
+
+    /* Live comparator state, never from the shadow */
+    if ((I2C_READ(id, uv_reg, &uv, 1U) != (status_t) kStatus_Success)
+        || (I2C_READ(id, ov_reg, &ov, 1U) != (status_t) kStatus_Success))
+    {
+        return SC_ERR_FAIL;
+    }
+
+    *pg = (((uv | ov) & BIT8(bit)) == 0U) ? SC_TRUE : SC_FALSE;
+
+    return SC_ERR_NONE;
+}
+
 /*--------------------------------------------------------------------------*/
 /* Service PMIC interrupt                                                   */
 /*--------------------------------------------------------------------------*/
@@ -752,6 +783,9 @@ sc_bool_t pf8100_pmic_irq_service(pmic_id_t id)
     uint8_t mask = 0U;
     uint8_t therm_stat = 0U;
 
+    /* PMIC may have acted on its own, drop the shadow */
+    pmic_shadow_invalidate_all(id);
+
     /* PMIC THERM */
     (void) I2C_READ(id, PF8100_THERMINT, &therm_stat, 1U);
     (void) I2C_READ(id, PF8100_THERMMASK, &mask, 1U);
@@ -774,6 +808,46 @@ sc_bool_t pf8100_pmic_irq_service(pmic_id_t id)
 }
 
 
+/*--------------------------------------------------------------------------*/
+/* Read a block of registers into the shadow                                */
+/*--------------------------------------------------------------------------*/
+sc_err_t pf8100_pmic_prefetch(pmic_id_t id, uint8_t reg, uint8_t count)
+{
+    sc_err_t rtn = SC_ERR_NONE;
+    uint32_t done = 0U;
+
+    if ((reg < PF8100_SHADOW_START) || ((U32(reg) + count) > 0x100U))
+    {
+        rtn = SC_ERR_PARM;
+    }
+
+    while ((rtn == SC_ERR_NONE) && (done < count))
+    {
+        uint8_t buf[PMIC_BURST_MAX];
+        uint8_t first = U8(U32(reg) + done);
+        uint8_t len = U8(MIN(U32(count) - done, PMIC_BURST_MAX));
+        uint8_t n;
+
+        if (I2C_READ_BURST(id, first, buf, len)
+            != (status_t) kStatus_Success)
+        {
+            error_print("pmic_prefetch - Failed to read PMIC %d, reg %u\n",
+                id, first);
+            rtn = SC_ERR_FAIL;
+        }
+        else
+        {
+            for (n = 0U; n < len; n++)
+            {
+                pmic_shadow_update(id, U8(first + n), buf[n]);
+            }
+            done += len;
+        }
+    }
+
+    return rtn;
+}
+
 /*--------------------------------------------------------------------------*/
 /* Check for Silicon Revision                                               */
 /*--------------------------------------------------------------------------*/
@@ -789,6 +863,7 @@ static inline sc_err_t check_si_rev(uint8_t address)
         == (status_t) kStatus_Success)
     {
         si_rev = buff;
+        pf8100_codec_init();
     }
     else
     {
@@ -798,3 +873,85 @@ static inline sc_err_t check_si_rev(uint8_t address)
     return SC_ERR_NONE;
 }
 
+/*--------------------------------------------------------------------------*/
+/* Build the voltage codecs for the silicon revision                        */
+/*--------------------------------------------------------------------------*/
+static void pf8100_codec_init(void)
+{
+    const uint32_t *ldo_lookup = ldo_table;
+
+    if (si_rev == A0_SI_REV)
+    {
+        ldo_lookup = ldo_table_a0;
+    }
+    else if ((si_rev == B0_SI_REV) || (si_rev == C0_SI_REV))
+    {
+        ldo_lookup = ldo_table_b0;
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    pmic_vcodec_init(&sw7_codec, sw7v_lookup, U8(ARRAY_SIZE(sw7v_lookup)));
+    pmic_vcodec_init(&ldo_codec, ldo_lookup, 16U);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Read a register, served from the shadow when possible                    */
+/*--------------------------------------------------------------------------*/
+static status_t pf8100_reg_read(pmic_id_t id, uint8_t reg, uint8_t *val)
+{
+    status_t err = (status_t) kStatus_Success;
+
+    if (reg < PF8100_SHADOW_START)
+    {
+        err = I2C_READ(id, reg, val, 1U);
+    }
+    else if (pmic_shadow_get(id, reg, val) == SC_FALSE)
+    {
+        err = I2C_READ(id, reg, val, 1U);
+        if (err == (status_t) kStatus_Success)
+        {
+            pmic_shadow_update(id, reg, *val);
+        }
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    return err;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Write a register through the shadow, skipped if already current          */
+/*--------------------------------------------------------------------------*/
+static status_t pf8100_reg_write(pmic_id_t id, uint8_t reg, uint8_t val)
+{
+    status_t err = (status_t) kStatus_Success;
+
+    if (reg < PF8100_SHADOW_START)
+    {
+        err = I2C_WRITE(id, reg, &val, 1U);
+    }
+    else if (pmic_shadow_current(id, reg, val) == SC_FALSE)
+    {
+        err = I2C_WRITE(id, reg, &val, 1U);
+        if (err == (status_t) kStatus_Success)
+        {
+            pmic_shadow_update(id, reg, val);
+        }
+        else
+        {
+            pmic_shadow_invalidate(id, reg);
+        }
+    }
+    else
+    {
+        ; /* Intentional empty else */
+    }
+
+    return err;
+}
+